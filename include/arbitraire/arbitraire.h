@@ -17,50 +17,141 @@ extern "C" {
 #include <time.h>
 
 typedef struct fxdpnt fxdpnt;
+typedef struct arb_bin arb_bin;
+typedef struct arb_intern_table arb_intern_table;
+typedef struct arb_float arb_float;
+
+/* arb_float rounding modes */
+#define ARB_RNDN 0	/* to nearest, ties to even */
+#define ARB_RNDZ 1	/* toward zero */
+#define ARB_RNDU 2	/* toward +infinity */
+#define ARB_RNDD 3	/* toward -infinity */
+#define ARB_RNDA 4	/* away from zero */
 
 /* function prototypes */
 /* arithmetic */
 fxdpnt *arb_mul(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
+fxdpnt *arb_addmul(const fxdpnt *, const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
 fxdpnt *arb_karatsuba_mul(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
 fxdpnt *arb_sub(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
 fxdpnt *arb_add(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
 fxdpnt *arb_newtonian_div(fxdpnt *, fxdpnt *, fxdpnt *, int, int, fxdpnt *);
 fxdpnt *arb_div(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
+void arb_div_space_free(void);
+fxdpnt *arb_divexact(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
+/* word operations */
+fxdpnt *arb_add_ui(const fxdpnt *, size_t, fxdpnt *, int);
+fxdpnt *arb_sub_ui(const fxdpnt *, size_t, fxdpnt *, int);
+fxdpnt *arb_mul_ui(const fxdpnt *, size_t, fxdpnt *, int);
+fxdpnt *arb_divmod_ui(const fxdpnt *, size_t, fxdpnt *, size_t *, int, size_t);
+int arb_cmp_ui(const fxdpnt *, size_t, int);
+size_t arb_mod_ui(const fxdpnt *, size_t, int);
+int arb_divisible_ui(const fxdpnt *, size_t, int);
+/* binary engine */
+arb_bin *arb_bin_from(const fxdpnt *, arb_bin *, int);
+fxdpnt *arb_bin_to(const arb_bin *, fxdpnt *, int);
+arb_bin *arb_bin_add(const arb_bin *, const arb_bin *, arb_bin *);
+arb_bin *arb_bin_sub(const arb_bin *, const arb_bin *, arb_bin *);
+arb_bin *arb_bin_mul(const arb_bin *, const arb_bin *, arb_bin *);
+int arb_bin_cmp(const arb_bin *, const arb_bin *);
+void arb_bin_print(const arb_bin *, int);
+void arb_bin_free(arb_bin *);
+/* floating point */
+arb_float *arb_float_from(const fxdpnt *, arb_float *, size_t, int, int);
+fxdpnt *arb_float_to(const arb_float *, fxdpnt *);
+arb_float *arb_float_add(const arb_float *, const arb_float *, arb_float *, int);
+arb_float *arb_float_sub(const arb_float *, const arb_float *, arb_float *, int);
+arb_float *arb_float_mul(const arb_float *, const arb_float *, arb_float *, int);
+arb_float *arb_float_div(const arb_float *, const arb_float *, arb_float *, int);
+arb_float *arb_float_sqrt(const arb_float *, arb_float *, int);
+void arb_float_print(const arb_float *);
+void arb_float_free(arb_float *);
 /* modulus */
 fxdpnt *arb_mod(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
 /* logical shift */
 fxdpnt *arb_leftshift(fxdpnt *, size_t);
 fxdpnt *arb_rightshift(fxdpnt *, size_t);
+/* bitwise */
+int arb_pow2base(int);
+fxdpnt *arb_and(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
+fxdpnt *arb_or(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
+fxdpnt *arb_xor(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
+fxdpnt *arb_shl_bits(const fxdpnt *, size_t, fxdpnt *, int);
+fxdpnt *arb_shr_bits(const fxdpnt *, size_t, fxdpnt *, int);
+/* radix shift */
+fxdpnt *arb_shift_radix(fxdpnt *, long);
+fxdpnt *arb_mul_basepow(const fxdpnt *, long, fxdpnt *);
+fxdpnt *arb_div_basepow(const fxdpnt *, long, fxdpnt *);
 /* general */
 void arb_flipsign(fxdpnt *);
 void arb_setsign(const fxdpnt *, const fxdpnt *, fxdpnt *);
 /* io */
-void arb_print(fxdpnt *);
+void arb_print(const fxdpnt *);
 fxdpnt *arb_str2fxdpnt(const char *);
-void arb_printtrue(fxdpnt *);
+void arb_printtrue(const fxdpnt *);
 /* comparison */
-int arb_compare(fxdpnt *, fxdpnt *);
+int arb_compare(const fxdpnt *, const fxdpnt *);
+int arb_cmp_mul(const fxdpnt *, const fxdpnt *, const fxdpnt *, int);
+int arb_cmp_sqr(const fxdpnt *, const fxdpnt *, int);
+int arb_equal(const fxdpnt *, const fxdpnt *);
 /* copying */
 fxdpnt *arb_copy(fxdpnt *, const fxdpnt *);
+fxdpnt *arb_share(fxdpnt *, const fxdpnt *);
+int arb_set_cow(int);
 /* sqrt */
 fxdpnt *nsqrt(fxdpnt *, int, size_t);
 fxdpnt *long_sqrt(fxdpnt *, int, size_t);
 fxdpnt *lhsqrt(fxdpnt *, int, size_t);
 /* general */
 void arb_init(fxdpnt *);
-void arb_error(char *);
+void arb_error(const char *);
 /* allocation */
 fxdpnt *arb_expand(fxdpnt *, size_t);
 void *arb_malloc(size_t);
 void *arb_realloc(void *, size_t);
 void *arb_calloc(size_t, size_t);
+void arb_dealloc(void *);
+void arb_set_allocator(void *(*)(size_t, void *), void *(*)(void *, size_t, void *),
+		       void (*)(void *, void *), void *);
 void arb_free(fxdpnt *);
 /* to hardware and back */
 fxdpnt *hrdware2arb(size_t);
 size_t fxd2sizet(fxdpnt *, int);
+fxdpnt *arb_from_u64(uint64_t, fxdpnt *, int);
+fxdpnt *arb_from_i64(int64_t, fxdpnt *, int);
+#ifdef __SIZEOF_INT128__
+fxdpnt *arb_from_i128(__int128, fxdpnt *, int);
+#endif
+fxdpnt *arb_from_double(double, fxdpnt *, int);
+int arb_to_i64(const fxdpnt *, int64_t *, int);
+double arb_to_double(const fxdpnt *, int);
+/* memo cache */
+void arb_memo_enable(size_t);
+void arb_memo_clear(void);
+void arb_memo_stats(size_t *, size_t *, size_t *);
+/* sort keys */
+size_t arb_sortkey_encode(const fxdpnt *, unsigned char *, size_t, int);
+size_t arb_sortkey_prefix(const fxdpnt *, unsigned char *, size_t, int);
+fxdpnt *arb_sortkey_decode(const unsigned char *, size_t, fxdpnt *);
+/* sorting */
+void arb_sort(fxdpnt **, size_t, int);
+void arb_topk(fxdpnt **, size_t, size_t, int);
+/* hashing and interning */
+uint64_t arb_hash(const fxdpnt *, uint64_t);
+arb_intern_table *arb_intern_new(uint64_t);
+const fxdpnt *arb_intern(arb_intern_table *, const fxdpnt *);
+size_t arb_intern_count(const arb_intern_table *);
+void arb_intern_free(arb_intern_table *);
+/* digit import and export */
+int arb_export_digits(const fxdpnt *, unsigned char *, size_t, size_t, char *);
+fxdpnt *arb_import_digits(fxdpnt *, const unsigned char *, size_t, size_t, char);
+/* views */
+fxdpnt *arb_view(fxdpnt *, const fxdpnt *, size_t, size_t, size_t);
+fxdpnt *arb_view_int(fxdpnt *, const fxdpnt *);
+fxdpnt *arb_view_frac(fxdpnt *, const fxdpnt *);
 /* general */
 fxdpnt *remove_leading_zeros(fxdpnt *);
-int iszero(fxdpnt*);
+int iszero(const fxdpnt *);
 /* exp */
 fxdpnt *arb_exp(fxdpnt *, fxdpnt *, fxdpnt *, int, size_t);
 /* novelties */
@@ -77,7 +168,7 @@ int oddity(size_t);
 /* new */
 fxdpnt *karatsuba(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, size_t scale);
 void arb_attrs(fxdpnt *, char *);
-size_t count_leading_fractional_zeros(fxdpnt *);
+size_t count_leading_fractional_zeros(const fxdpnt *);
 fxdpnt *arb_comba(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
 #ifdef __cplusplus
 }
@@ -0,0 +1,533 @@
+#ifndef ARBITRAIRE_HPP
+#define ARBITRAIRE_HPP
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	A C++ interface to arbitraire.
+
+	arb::number owns an fxdpnt and frees it when it goes out of scope.
+	Moving a number moves its digits, and copying it uses arb_copy (so it
+	shares digits in copy-on-write mode).
+
+	The operators build expression templates instead of numbers, and an
+	expression is only evaluated when it is assigned to a number. This
+	means a*b + c is done with a single arb_addmul, which adds the
+	product into the digits of c without forming it on its own, and
+	x = x + y writes into a per-thread scratch number whose digits are
+	reused from one assignment to the next, rather than allocating a
+	result each time.
+
+	The base and scale used by the operators are taken from arb::ctx(),
+	which is per thread and defaults to base 10 and scale 0.
+
+	With C++17, arb::use_memory_resource() routes all of arbitraire's
+	allocations to a std::pmr::memory_resource. Like arb_set_allocator(),
+	it has to be called before the first number is made, and the resource
+	has to outlive every number, including the scratch number of each
+	thread, which arb::release_scratch() frees early.
+*/
+
+#include <arbitraire/arbitraire.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <type_traits>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+
+namespace arb {
+
+struct context {
+	int base;
+	size_t scale;
+};
+
+inline context &ctx()
+{
+	static thread_local context c = { 10, 0 };
+	return c;
+}
+
+template <class L, class R, class Op> class expr;
+
+namespace detail {
+
+struct add_op {
+	static fxdpnt *apply(const fxdpnt *a, const fxdpnt *b, fxdpnt *c)
+	{
+		return arb_add(a, b, c, ctx().base);
+	}
+};
+
+struct sub_op {
+	static fxdpnt *apply(const fxdpnt *a, const fxdpnt *b, fxdpnt *c)
+	{
+		return arb_sub(a, b, c, ctx().base);
+	}
+};
+
+struct mul_op {
+	static fxdpnt *apply(const fxdpnt *a, const fxdpnt *b, fxdpnt *c)
+	{
+		return arb_mul(a, b, c, ctx().base, ctx().scale);
+	}
+};
+
+struct div_op {
+	static fxdpnt *apply(const fxdpnt *a, const fxdpnt *b, fxdpnt *c)
+	{
+		return arb_div(a, b, c, ctx().base, ctx().scale);
+	}
+};
+
+struct mod_op {
+	static fxdpnt *apply(const fxdpnt *a, const fxdpnt *b, fxdpnt *c)
+	{
+		return arb_mod(a, b, c, ctx().base, ctx().scale);
+	}
+};
+
+template <class T> struct is_expr : std::false_type { };
+template <class L, class R, class Op> struct is_expr<expr<L, R, Op> > : std::true_type { };
+
+/* results are built in here and then swapped into their destination */
+struct scratch {
+	fxdpnt *p;
+	scratch() : p(nullptr) { }
+	~scratch() { arb_free(p); }
+};
+
+inline fxdpnt *&spare()
+{
+	static thread_local scratch s;
+	return s.p;
+}
+
+} /* namespace detail */
+
+inline void release_scratch()
+{
+	arb_free(detail::spare());
+	detail::spare() = nullptr;
+}
+
+class number {
+public:
+	number() : p_(arb_str2fxdpnt("0")) { }
+	explicit number(const char *s) : p_(arb_str2fxdpnt(s)) { }
+	explicit number(const std::string &s) : p_(arb_str2fxdpnt(s.c_str())) { }
+	number(const number &o) : p_(arb_copy(nullptr, o.p_)) { }
+	number(number &&o) noexcept : p_(o.p_) { o.p_ = nullptr; }
+	template <class L, class R, class Op>
+	number(const expr<L, R, Op> &e) : p_(e.eval(nullptr)) { }
+	~number() { arb_free(p_); }
+
+	number &operator=(const number &o)
+	{
+		if (this != &o)
+			p_ = arb_copy(p_, o.p_);
+		return *this;
+	}
+
+	number &operator=(number &&o) noexcept
+	{
+		std::swap(p_, o.p_);
+		return *this;
+	}
+
+	/* evaluate into the spare number, then trade it for our digits */
+	template <class L, class R, class Op>
+	number &operator=(const expr<L, R, Op> &e)
+	{
+		fxdpnt *&s = detail::spare();
+		s = e.eval(s);
+		std::swap(s, p_);
+		return *this;
+	}
+
+	template <class T> number &operator+=(const T &o) { return *this = *this + o; }
+	template <class T> number &operator-=(const T &o) { return *this = *this - o; }
+	template <class T> number &operator*=(const T &o) { return *this = *this * o; }
+	template <class T> number &operator/=(const T &o) { return *this = *this / o; }
+	template <class T> number &operator%=(const T &o) { return *this = *this % o; }
+
+	/* take ownership of, or give up, the underlying fxdpnt */
+	static number adopt(fxdpnt *p)
+	{
+		number n(nullptr);
+		n.p_ = p;
+		return n;
+	}
+
+	fxdpnt *release()
+	{
+		fxdpnt *p = p_;
+		p_ = nullptr;
+		return p;
+	}
+
+	const fxdpnt *get() const { return p_; }
+	fxdpnt *get() { return p_; }
+
+	void print() const { arb_print(p_); }
+
+private:
+	explicit number(std::nullptr_t) : p_(nullptr) { }
+	fxdpnt *p_;
+};
+
+namespace detail {
+
+/* an operand as an fxdpnt, evaluating it first if it is an expression */
+template <class T> struct hold {
+	number n;
+	const fxdpnt *p;
+	hold(const T &e) : n(e), p(n.get()) { }
+};
+
+template <> struct hold<number> {
+	const fxdpnt *p;
+	hold(const number &n) : p(n.get()) { }
+};
+
+template <class Op, class L, class R>
+fxdpnt *evaluate(Op, const L &l, const R &r, fxdpnt *dst)
+{
+	hold<L> a(l);
+	hold<R> b(r);
+	return Op::apply(a.p, b.p, dst);
+}
+
+/* a*b + c and c + a*b are fused into arb_addmul */
+template <class A, class B>
+fxdpnt *addmul(const A &a, const B &b, const fxdpnt *c, fxdpnt *dst)
+{
+	hold<A> x(a);
+	hold<B> y(b);
+	return arb_addmul(x.p, y.p, c, dst, ctx().base, ctx().scale);
+}
+
+template <class A, class B, class C>
+fxdpnt *evaluate(add_op, const expr<A, B, mul_op> &l, const C &r, fxdpnt *dst)
+{
+	hold<C> c(r);
+	return addmul(l.left(), l.right(), c.p, dst);
+}
+
+template <class A, class B, class C>
+fxdpnt *evaluate(add_op, const C &l, const expr<A, B, mul_op> &r, fxdpnt *dst)
+{
+	hold<C> c(l);
+	return addmul(r.left(), r.right(), c.p, dst);
+}
+
+template <class A, class B, class C, class D>
+fxdpnt *evaluate(add_op, const expr<A, B, mul_op> &l, const expr<C, D, mul_op> &r, fxdpnt *dst)
+{
+	hold<expr<C, D, mul_op> > c(r);
+	return addmul(l.left(), l.right(), c.p, dst);
+}
+
+} /* namespace detail */
+
+template <class L, class R, class Op> class expr {
+public:
+	expr(const L &l, const R &r) : l_(l), r_(r) { }
+	fxdpnt *eval(fxdpnt *dst) const { return detail::evaluate(Op(), l_, r_, dst); }
+	const L &left() const { return l_; }
+	const R &right() const { return r_; }
+private:
+	/* numbers are held by reference and expressions by value */
+	typename std::conditional<detail::is_expr<L>::value, const L, const L &>::type l_;
+	typename std::conditional<detail::is_expr<R>::value, const R, const R &>::type r_;
+};
+
+namespace detail {
+
+template <class T> struct is_operand : is_expr<T> { };
+template <> struct is_operand<number> : std::true_type { };
+
+template <class L, class R, class Op>
+using expr_if = typename std::enable_if<is_operand<L>::value && is_operand<R>::value,
+					expr<L, R, Op> >::type;
+
+} /* namespace detail */
+
+template <class L, class R>
+detail::expr_if<L, R, detail::add_op> operator+(const L &l, const R &r)
+{
+	return expr<L, R, detail::add_op>(l, r);
+}
+
+template <class L, class R>
+detail::expr_if<L, R, detail::sub_op> operator-(const L &l, const R &r)
+{
+	return expr<L, R, detail::sub_op>(l, r);
+}
+
+template <class L, class R>
+detail::expr_if<L, R, detail::mul_op> operator*(const L &l, const R &r)
+{
+	return expr<L, R, detail::mul_op>(l, r);
+}
+
+template <class L, class R>
+detail::expr_if<L, R, detail::div_op> operator/(const L &l, const R &r)
+{
+	return expr<L, R, detail::div_op>(l, r);
+}
+
+template <class L, class R>
+detail::expr_if<L, R, detail::mod_op> operator%(const L &l, const R &r)
+{
+	return expr<L, R, detail::mod_op>(l, r);
+}
+
+inline int compare(const number &a, const number &b) { return arb_compare(a.get(), b.get()); }
+inline bool operator==(const number &a, const number &b) { return arb_equal(a.get(), b.get()) != 0; }
+inline bool operator!=(const number &a, const number &b) { return !(a == b); }
+inline bool operator<(const number &a, const number &b) { return compare(a, b) < 0; }
+inline bool operator>(const number &a, const number &b) { return compare(a, b) > 0; }
+inline bool operator<=(const number &a, const number &b) { return compare(a, b) <= 0; }
+inline bool operator>=(const number &a, const number &b) { return compare(a, b) >= 0; }
+
+/*
+	arb::fixed<Digits, Scale, Base> is a number with at most 'Digits'
+	integer digits and exactly 'Scale' fractional digits, kept on the
+	stack. Its kernels loop over a length known at compile time, so there
+	is no len/lp bookkeeping and the compiler can unroll them. Results
+	follow bc: they are truncated to the scale. A result that needs more
+	than 'Digits' integer digits is an error.
+
+	Fixed numbers convert to and from arb::number (and so fxdpnt) through
+	arb_export_digits() and arb_import_digits().
+*/
+template <size_t Digits, size_t Scale, int Base = 10> class fixed {
+public:
+	static constexpr size_t N = Digits + Scale;
+	static_assert(N > 0, "arb::fixed needs at least one digit");
+
+	fixed() : neg_(false), d_() { }
+
+	explicit fixed(const number &n) : neg_(false), d_()
+	{
+		char sign = '+';
+		if (arb_export_digits(n.get(), d_, Digits, Scale, &sign))
+			arb_error("arb::fixed: number is too large");
+		neg_ = sign == '-' && !zero();
+	}
+
+	explicit fixed(const char *s) : fixed(number(s)) { }
+
+	number to_number() const
+	{
+		return number::adopt(arb_import_digits(nullptr, d_, N, Digits, neg_ ? '-' : '+'));
+	}
+
+	void print() const { to_number().print(); }
+
+	bool zero() const
+	{
+		for (size_t i = 0; i < N; ++i)
+			if (d_[i])
+				return false;
+		return true;
+	}
+
+	friend fixed operator+(const fixed &a, const fixed &b) { return addsign(a, b, b.neg_); }
+	friend fixed operator-(const fixed &a, const fixed &b) { return addsign(a, b, !b.neg_); }
+
+	friend fixed operator*(const fixed &a, const fixed &b)
+	{
+		/* column sums of the 2N digit product, then a single carry pass */
+		unsigned long col[2 * N] = { 0 };
+		fixed c;
+		size_t i = 0;
+		size_t j = 0;
+		unsigned long cy = 0;
+
+		for (i = 0; i < N; ++i)
+			for (j = 0; j < N; ++j)
+				col[i + j + 1] += a.d_[i] * b.d_[j];
+		for (i = 2 * N; i-- > 0;) {
+			col[i] += cy;
+			cy = col[i] / Base;
+			col[i] %= Base;
+		}
+		/* the product has 2 * Scale fractional digits, keep Scale */
+		for (i = 0; i < Digits; ++i)
+			if (col[i])
+				arb_error("arb::fixed: product is too large");
+		for (i = 0; i < N; ++i)
+			c.d_[i] = col[Digits + i];
+		c.neg_ = a.neg_ != b.neg_ && !c.zero();
+		return c;
+	}
+
+	friend fixed operator/(const fixed &a, const fixed &b)
+	{
+		/* long division of a * Base^Scale by b, a digit at a time */
+		unsigned char r[N + 1] = { 0 };
+		unsigned char v[N + 1] = { 0 };
+		fixed c;
+		size_t i = 0;
+
+		if (b.zero())
+			arb_error("arb::fixed: divide by zero");
+		for (i = 0; i < N; ++i)
+			v[i + 1] = b.d_[i];
+		for (i = 0; i < N + Scale; ++i) {
+			unsigned char q = 0;
+			for (size_t k = 0; k < N; ++k)
+				r[k] = r[k + 1];
+			r[N] = i < N ? a.d_[i] : 0;
+			while (ucmp(r, v, N + 1) >= 0) {
+				usub(r, v, N + 1);
+				++q;
+			}
+			if (i < Scale) {
+				if (q)
+					arb_error("arb::fixed: quotient is too large");
+			} else {
+				c.d_[i - Scale] = q;
+			}
+		}
+		c.neg_ = a.neg_ != b.neg_ && !c.zero();
+		return c;
+	}
+
+	fixed &operator+=(const fixed &o) { return *this = *this + o; }
+	fixed &operator-=(const fixed &o) { return *this = *this - o; }
+	fixed &operator*=(const fixed &o) { return *this = *this * o; }
+	fixed &operator/=(const fixed &o) { return *this = *this / o; }
+
+	friend int compare(const fixed &a, const fixed &b)
+	{
+		int m = ucmp(a.d_, b.d_, N);
+		if (a.neg_ != b.neg_)
+			return a.neg_ ? -1 : 1;
+		return a.neg_ ? -m : m;
+	}
+
+	friend bool operator==(const fixed &a, const fixed &b) { return compare(a, b) == 0; }
+	friend bool operator!=(const fixed &a, const fixed &b) { return compare(a, b) != 0; }
+	friend bool operator<(const fixed &a, const fixed &b) { return compare(a, b) < 0; }
+	friend bool operator>(const fixed &a, const fixed &b) { return compare(a, b) > 0; }
+	friend bool operator<=(const fixed &a, const fixed &b) { return compare(a, b) <= 0; }
+	friend bool operator>=(const fixed &a, const fixed &b) { return compare(a, b) >= 0; }
+
+private:
+	static int ucmp(const unsigned char *a, const unsigned char *b, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+			if (a[i] != b[i])
+				return a[i] > b[i] ? 1 : -1;
+		return 0;
+	}
+
+	/* a -= b, where a >= b */
+	static void usub(unsigned char *a, const unsigned char *b, size_t n)
+	{
+		int br = 0;
+		for (size_t i = n; i-- > 0;) {
+			int t = a[i] - b[i] - br;
+			br = t < 0;
+			a[i] = br ? t + Base : t;
+		}
+	}
+
+	/* a + b, where b is negative when 'bneg' is set */
+	static fixed addsign(const fixed &a, const fixed &b, bool bneg)
+	{
+		fixed c;
+		if (a.neg_ == bneg) {
+			int cy = 0;
+			for (size_t i = N; i-- > 0;) {
+				int t = a.d_[i] + b.d_[i] + cy;
+				cy = t >= Base;
+				c.d_[i] = cy ? t - Base : t;
+			}
+			if (cy)
+				arb_error("arb::fixed: sum is too large");
+			c.neg_ = a.neg_;
+		} else if (ucmp(a.d_, b.d_, N) >= 0) {
+			c = a;
+			usub(c.d_, b.d_, N);
+			c.neg_ = a.neg_;
+		} else {
+			c = b;
+			usub(c.d_, a.d_, N);
+			c.neg_ = bneg;
+		}
+		c.neg_ = c.neg_ && !c.zero();
+		return c;
+	}
+
+	bool neg_;
+	unsigned char d_[N];
+};
+
+#if __cplusplus >= 201703L
+namespace detail {
+
+/* each block records its size in front of itself for deallocate() */
+struct pmr_hooks {
+	static constexpr size_t head = alignof(std::max_align_t);
+
+	static void *alloc(size_t n, void *ctx)
+	{
+		auto mr = static_cast<std::pmr::memory_resource *>(ctx);
+		char *p = nullptr;
+		try {
+			p = static_cast<char *>(mr->allocate(n + head, head));
+		} catch (...) {
+			/* arbitraire reports the failure itself */
+			return nullptr;
+		}
+		std::memcpy(p, &n, sizeof(n));
+		return p + head;
+	}
+
+	static size_t size(void *p)
+	{
+		size_t n = 0;
+		std::memcpy(&n, static_cast<char *>(p) - head, sizeof(n));
+		return n;
+	}
+
+	static void dealloc(void *p, void *ctx)
+	{
+		auto mr = static_cast<std::pmr::memory_resource *>(ctx);
+		mr->deallocate(static_cast<char *>(p) - head, size(p) + head, head);
+	}
+
+	static void *realloc(void *p, size_t n, void *ctx)
+	{
+		void *q = alloc(n, ctx);
+		if (p && q) {
+			std::memcpy(q, p, size(p) < n ? size(p) : n);
+			dealloc(p, ctx);
+		}
+		return q;
+	}
+};
+
+} /* namespace detail */
+
+inline void use_memory_resource(std::pmr::memory_resource *mr)
+{
+	if (mr)
+		arb_set_allocator(detail::pmr_hooks::alloc, detail::pmr_hooks::realloc,
+				  detail::pmr_hooks::dealloc, mr);
+	else
+		arb_set_allocator(nullptr, nullptr, nullptr, nullptr);
+}
+#endif
+
+} /* namespace arb */
+
+#endif
@@ -4,19 +4,11 @@
 
 
 /*
-	While many subtraction routines require that the numbers first
-	be compared and then rearranged in the case that the zero threshold
-	is crossed, we mitigate this by using a special property of
-	subtraction that takes advantage of a left over carry. When a
-	left over carry is detected, the inverse of the solution is used.
-	Ergo, if the solution was 999 we would perform the operation:
-
-		answer = 1000 - 999
-
-	Instead of performing this operation in its entirety however, the
-	inverse solution is calculated alongside the normative one and
-	simply discarded in the case it is not needed (when there is no left
-	over carry).
+	Subtraction compares the magnitudes of its operands first, stopping at
+	the first digit in which they differ, and then always subtracts the
+	smaller from the larger, flipping the sign of the result when they
+	were swapped. There is then never a borrow left over, and the result
+	is written once, straight into the destination.
 
 	Addition:
 
@@ -43,139 +35,120 @@
 
 		five_loop_sub:
 
-			Work in progress 
+			The counterpart of six_loop_add, with a loop for each
+			stretch of digits rather than a conditional for each
+			digit.
+
+*/
 
-			Correct output
+/* the sign of |a| - |b|, from the first digit in which they differ */
+static int _arb_cmp_mag(const fxdpnt *a, const fxdpnt *b)
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t n = 0;
+	int r = 0;
+
+	/* the integer digits which only one of them has */
+	for (; rl(a) - i > rl(b); ++i)
+		if (a->number[i])
+			return 1;
+	for (; rl(b) - j > rl(a); ++j)
+		if (b->number[j])
+			return -1;
+
+	/* the digits are now lined up, and are compared a word at a time */
+	n = MIN(a->len - i, b->len - j);
+	if ((r = memcmp(a->number + i, b->number + j, n * sizeof(UARBT))))
+		return r > 0 ? 1 : -1;
+	if (arb_trailing_zeros(a->number + i + n, a->len - i - n) != a->len - i - n)
+		return 1;
+	if (arb_trailing_zeros(b->number + j + n, b->len - j - n) != b->len - j - n)
+		return -1;
+	return 0;
+}
 
-			Note that most implementations are using compare()
-		       	beforehand for subtractions
+/* put the operand with the larger magnitude first */
+static void _arb_sub_order(const fxdpnt **a, const fxdpnt **b, fxdpnt *c)
+{
+	const fxdpnt *t = *a;
 
-*/
+	if (_arb_cmp_mag(*a, *b) < 0) {
+		*a = *b;
+		*b = t;
+		arb_flipsign(c);
+	}
+}
 
 fxdpnt *five_loop_sub(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 {
 	size_t i = 0;
-	size_t k = 0;	
+	size_t k = 0;
 	size_t j = 0;
 	size_t len = 0;
 	ARBT sum = 0;
 	int8_t borrow = 0;
-	int8_t mborrow = -1; /* mirror borrow must be -1 */
-	ARBT mir = 0;
-	UARBT *array = NULL;
-	UARBT *tmp = NULL;
-	ARBT hold = 0;
-	
-	size_t array_allocated = (MAX(rr(a), rr(b)) + MAX(rl(a), rl(b)) + 1);
-
-	array = arb_malloc(array_allocated * sizeof(UARBT));
-	j = MAX(rr(a), rr(b)) + MAX(rl(a), rl(b)) -1;
+	size_t y = 0;
+	size_t z = 0;
+	int bits = arb_pow2base(base);
 
-	size_t y = b->len-1;
-	size_t z = a->len-1;
+	_arb_sub_order(&a, &b, c);
+	j = MAX(rr(a), rr(b)) + MAX(rl(a), rl(b)) - 1;
+	y = b->len - 1;
+	z = a->len - 1;
 
 	/* take care of differing tails to the right of the radix */
 	if (rr(a) > rr(b)) {
 		len = rr(a) - rr(b);
-		for (i=0;i < len; i++, j--, z--, c->len++) {
-			hold = a->number[z];
-			sum = hold + borrow;
-			mir = hold + mborrow;
-			borrow = mborrow = 0;
-			if(sum < 0) {
-				borrow = -1;
-				sum += base;
-			}
-			if(mir < 0) {
-				mborrow = -1;
-				mir += base;
-			}
-			c->number[j] = sum;
-			array[j] = (base-1) - mir;
-		}
+		for (i = 0; i < len; i++, j--, z--, c->len++)
+			c->number[j] = a->number[z];
 	}
 	/* perform subtraction from 0 on the bottom long tail */
 	else if (rr(b) > rr(a)) {
 		len = rr(b) - rr(a);
-		for (k=0;k < len; k++, j--, y--, c->len++) {
-			hold = 0 - b->number[y];
-			sum = hold + borrow;
-			mir = hold + mborrow;
-			borrow = mborrow = 0;
-			if(sum < 0) {
+		for (k = 0; k < len; k++, j--, y--, c->len++) {
+			sum = borrow - b->number[y];
+			borrow = 0;
+			if (sum < 0) {
 				borrow = -1;
 				sum += base;
 			}
-			if(mir < 0) {
-				mborrow = -1;
-				mir += base;
-			}
 			c->number[j] = sum;
-			array[j] = (base-1) - mir;
 		}
 	}
 
-	for (;i < a->len && k < b->len; j--, c->len++, i++, k++, z--, y--) { 
-		hold = a->number[z] - b->number[y]; 
-		sum = hold + borrow;
-		mir = hold + mborrow;
-		borrow = mborrow = 0;
-		if(sum < 0) {
-			borrow = -1;
-			sum += base;
-		}
-		if(mir < 0) {
-			mborrow = -1;
-			mir += base;
+	/* in a base of 2^bits the borrow is the sign, and the digit a mask */
+	if (bits) {
+		for (; i < a->len && k < b->len; j--, c->len++, i++, k++, z--, y--) {
+			sum = a->number[z] - b->number[y] + borrow;
+			borrow = -(sum < 0);
+			c->number[j] = sum & (base - 1);
 		}
-		c->number[j] = sum;
-		array[j] = (base-1) - mir;
 	}
-
-	for (;i < a->len; j--, c->len++, i++, z--) { 
-		hold = a->number[z]; 
-		sum = hold + borrow;
-		mir = hold + mborrow;
-		borrow = mborrow = 0;
-		if(sum < 0) {
+	for (; i < a->len && k < b->len; j--, c->len++, i++, k++, z--, y--) {
+		sum = a->number[z] - b->number[y] + borrow;
+		borrow = 0;
+		if (sum < 0) {
 			borrow = -1;
 			sum += base;
 		}
-		if(mir < 0) {
-			mborrow = -1;
-			mir += base;
-		}
 		c->number[j] = sum;
-		array[j] = (base-1) - mir;
 	}
 
-	for (;k < b->len; j--, c->len++, k++, y--) { 
-		hold = 0 - b->number[y];
-		sum = hold + borrow;
-		mir = hold + mborrow;
-		borrow = mborrow = 0;
-		if(sum < 0) {
+	for (; i < a->len; j--, c->len++, i++, z--) {
+		sum = a->number[z] + borrow;
+		borrow = 0;
+		if (sum < 0) {
 			borrow = -1;
 			sum += base;
 		}
-		if(mir < 0) {
-			mborrow = -1;
-			mir += base;
-		}
 		c->number[j] = sum;
-		array[j] = (base-1) - mir;
 	}
 
-	/* a left over borrow indicates that the zero threshold was crossed */
-	if (borrow == -1) {
-		tmp = c->number;
-		c->number = array;
-		c->allocated = array_allocated; // TODO: this should be scaled
-		free(tmp);
-		arb_flipsign(c);
-	}else {
-		free(array);
-	}
+	/* what is left of the smaller number is leading zeros */
+	for (; k < b->len; j--, c->len++, k++)
+		c->number[j] = 0;
+
 	return c;
 }
 
@@ -196,6 +169,7 @@ fxdpnt *six_loop_add(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 	int carry = 0;
 	size_t z = a->len -1;
 	size_t y = b->len -1;
+	int bits = arb_pow2base(base);
 
 	/* take care of differing tails to the right of the radix */
 	if (rr(a) > rr(b)) {
@@ -212,6 +186,13 @@ fxdpnt *six_loop_add(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 	}
 
 	/* numbers are now compatible for a straight-forward add */
+	if (bits) {
+		for (;i < a->len && k < b->len; i++, j--, k++, z--, y--, c->len++) {
+			sum = a->number[z] + b->number[y] + carry;
+			carry = sum >> bits;
+			c->number[j] = sum & (base - 1);
+		}
+	}
 	for (;i < a->len && k < b->len; i++, j--, k++, z--, y--, c->len++) {
 		sum = a->number[z] + b->number[y] + carry; 
 		carry = 0;
@@ -314,49 +295,36 @@ fxdpnt *arb_sub_inter(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 	size_t j = 0;
 	ARBT sum = 0;
 	int8_t borrow = 0;
-	int8_t mborrow = -1; /* mirror borrow must be -1 */
-	ARBT mir = 0;
-	UARBT *array = NULL;
-	UARBT *tmp = NULL;
-	ARBT hold = 0;
 	size_t size = 0;
-	size_t array_allocated = (MAX(rr(a), rr(b)) + MAX(rl(a), rl(b)) + 1);
 
-	array = arb_malloc(array_allocated * sizeof(UARBT));
+	_arb_sub_order(&a, &b, c);
 	size = MAX(rr(a), rr(b)) + MAX(rl(a), rl(b)) - 1;
 
 	for (;i < a->len || j < b->len; size--, c->len++) {
-		hold = _pl(a, b, &i, c->len) - _pl(b, a, &j, c->len);
-		sum = hold + borrow;
-		mir = hold + mborrow;
-		borrow = mborrow = 0;
+		sum = _pl(a, b, &i, c->len) - _pl(b, a, &j, c->len) + borrow;
+		borrow = 0;
 		if(sum < 0) {
 			borrow = -1;
 			sum += base;
 		}
-		if(mir < 0) {
-			mborrow = -1;
-			mir += base;
-		}
 		c->number[size] = sum;
-		array[size] = (base-1) - mir;
-	}
-	/* a left over borrow indicates that the zero threshold was crossed */
-	if (borrow == -1) {
-		tmp = c->number;
-		c->number = array;
-		c->allocated = array_allocated; // TODO: this should be scaled
-		free(tmp);
-		arb_flipsign(c);
-	}else {
-		free(array);
 	}
 	return c;
 }
 /* identity redirection for add and sub */
 fxdpnt *arb_add2(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 {
-	fxdpnt *c2 = arb_expand(NULL, MAX(rr(a), rr(b)) + MAX(rl(a), rl(b)) + 1);
+	fxdpnt ta[1] = { 0 };
+	fxdpnt tb[1] = { 0 };
+	long e = MIN(a->exp, b->exp);
+	fxdpnt *c2 = arb_aliases(c, a) || arb_aliases(c, b) ? NULL : c;
+
+	/* line the operands up on the smaller of their exponents */
+	a = arb_align(a, a->exp - e, ta);
+	b = arb_align(b, b->exp - e, tb);
+
+	/* the output is written over when it shares no digits with the inputs */
+	c2 = arb_expand(c2, MAX(rr(a), rr(b)) + MAX(rl(a), rl(b)) + 1);
 	arb_init(c2);
 	c2->lp = MAX(rl(a), rl(b));
 	if (a->sign == '-' && b->sign == '-') {
@@ -364,30 +332,41 @@ fxdpnt *arb_add2(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 		c2 = six_loop_add(a, b, c2, base);
 	}
 	else if (a->sign == '-') {
-		c2 = arb_sub_inter(b, a, c2, base);
-		//c2 = five_loop_sub(b, a, c2, base);
+		c2 = five_loop_sub(b, a, c2, base);
 	}
 	else if (b->sign == '-') {
-		c2 = arb_sub_inter(a, b, c2, base);
-		//c2 = five_loop_sub(a, b, c2, base);
+		c2 = five_loop_sub(a, b, c2, base);
 	}
 	else {
 		c2 = six_loop_add(a, b, c2, base);
 	}
-	arb_free(c);
+	c2->exp = e;
+	arb_release(ta);
+	arb_release(tb);
+	if (c2 != c)
+		arb_free(c);
 	return c2;
 }
 
 fxdpnt *arb_sub2(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 {
-	fxdpnt *c2 = arb_expand(NULL, MAX(rr(a), rr(b)) + MAX(rl(a), rl(b)) + 1);
+	fxdpnt ta[1] = { 0 };
+	fxdpnt tb[1] = { 0 };
+	long e = MIN(a->exp, b->exp);
+	fxdpnt *c2 = arb_aliases(c, a) || arb_aliases(c, b) ? NULL : c;
+
+	/* line the operands up on the smaller of their exponents */
+	a = arb_align(a, a->exp - e, ta);
+	b = arb_align(b, b->exp - e, tb);
+
+	/* the output is written over when it shares no digits with the inputs */
+	c2 = arb_expand(c2, MAX(rr(a), rr(b)) + MAX(rl(a), rl(b)) + 1);
 	arb_init(c2);
 	c2->lp = MAX(rl(a), rl(b));
 	if (a->sign == '-' && b->sign == '-')
 	{
 		arb_flipsign(c2);
-		c2 = arb_sub_inter(a, b, c2, base);
-		//c2 = five_loop_sub(a, b, c2, base);
+		c2 = five_loop_sub(a, b, c2, base);
 	}
 	else if (a->sign == '-'){
 		arb_flipsign(c2);
@@ -397,10 +376,13 @@ fxdpnt *arb_sub2(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 		c2 = six_loop_add(a, b, c2, base);
 	}
 	else {
-		c2 = arb_sub_inter(a, b, c2, base);
-		//c2 = five_loop_sub(a, b, c2, base);
+		c2 = five_loop_sub(a, b, c2, base);
 	}
-	arb_free(c);
+	c2->exp = e;
+	arb_release(ta);
+	arb_release(tb);
+	if (c2 != c)
+		arb_free(c);
 	return c2;
 }
 
@@ -436,14 +418,14 @@ void add(const fxdpnt *a, const fxdpnt *b, fxdpnt **c, int base, char *m)
 void decr(fxdpnt **c, int base, char *m)
 {
 	_internal_debug; 
-	*c = arb_sub(*c, one, *c, base);
+	*c = arb_sub_ui(*c, 1, *c, base);
 	_internal_debug_end;
 }
 
 void incr(fxdpnt **c, int base, char *m)
 {
 	_internal_debug; 
-	*c = arb_add(*c, one, *c, base);
+	*c = arb_add_ui(*c, 1, *c, base);
 	_internal_debug_end;
 }
 void sub2(const fxdpnt *a, const fxdpnt *b, fxdpnt **c, int base, char *m)
@@ -0,0 +1,294 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	arb_bin is an alternative engine for integers which holds a number in
+	binary limbs (2^64 where the compiler has a 128 bit type, 2^32
+	otherwise) instead of one digit per byte. Chains of integer operations
+	on arb_bin run at the full width of a hardware word and multiply limbs
+	with native double word products.
+
+	Numbers enter and leave the engine through arb_bin_from and arb_bin_to.
+	Only the integer part of an fxdpnt is converted. Conversion works a
+	limb's worth of digits at a time (base^k for the largest k that fits
+	in a limb), so it is quadratic, but it only happens when a number in
+	a digit base is asked for. The digit form is cached in the arb_bin
+	after the first conversion (or kept from arb_bin_from) and is dropped
+	by the first write, so printing the same result twice or printing an
+	input costs nothing extra.
+
+	The output of every operation may be NULL, in which case it is
+	allocated, and may be the same as either input.
+*/
+
+static arb_bin *_bin_expand(arb_bin *x, size_t n)
+{
+	if (x == NULL) {
+		x = arb_malloc(sizeof(arb_bin));
+		x->limb = NULL;
+		x->n = x->allocated = 0;
+		x->sign = '+';
+		x->dec = NULL;
+		x->dec_base = 0;
+	}
+	/* the number is about to change, so its digit form is stale */
+	arb_free(x->dec);
+	x->dec = NULL;
+	if (n > x->allocated) {
+		x->limb = arb_realloc(x->limb, n * sizeof(arb_limb));
+		x->allocated = n;
+	}
+	return x;
+}
+
+static arb_bin *_bin_norm(arb_bin *x)
+{
+	while (x->n && !x->limb[x->n - 1])
+		--x->n;
+	if (x->n == 0)
+		x->sign = '+';
+	return x;
+}
+
+static int _bin_ucmp(const arb_bin *a, const arb_bin *b)
+{
+	size_t i = a->n;
+
+	if (a->n != b->n)
+		return a->n > b->n ? 1 : -1;
+	while (i--)
+		if (a->limb[i] != b->limb[i])
+			return a->limb[i] > b->limb[i] ? 1 : -1;
+	return 0;
+}
+
+/* c = |a| + |b|, any of which may be the same */
+static arb_bin *_bin_uadd(const arb_bin *a, const arb_bin *b, arb_bin *c)
+{
+	size_t an = a->n;
+	size_t bn = b->n;
+	size_t n = MAX(an, bn);
+	size_t i = 0;
+	arb_limb cy = 0;
+	arb_limb s = 0;
+	arb_limb t = 0;
+
+	c = _bin_expand(c, n + 1);
+	for (; i < n; ++i) {
+		s = (i < an ? a->limb[i] : 0) + cy;
+		cy = s < cy;
+		t = (i < bn ? b->limb[i] : 0);
+		s += t;
+		cy |= s < t;
+		c->limb[i] = s;
+	}
+	c->limb[n] = cy;
+	c->n = n + 1;
+	return c;
+}
+
+/* c = |a| - |b|, where |a| >= |b| */
+static arb_bin *_bin_usub(const arb_bin *a, const arb_bin *b, arb_bin *c)
+{
+	size_t an = a->n;
+	size_t bn = b->n;
+	size_t i = 0;
+	arb_limb br = 0;
+	arb_limb s = 0;
+	arb_limb t = 0;
+
+	c = _bin_expand(c, an);
+	for (; i < an; ++i) {
+		s = a->limb[i];
+		t = (i < bn ? b->limb[i] : 0) + br;
+		br = t < br;
+		br |= s < t;
+		c->limb[i] = s - t;
+	}
+	c->n = an;
+	return c;
+}
+
+/* c = a + b where b has the sign 'bs' */
+static arb_bin *_bin_addsign(const arb_bin *a, const arb_bin *b, char bs, arb_bin *c)
+{
+	char as = a->sign;
+
+	if (as == bs) {
+		c = _bin_uadd(a, b, c);
+		c->sign = as;
+	} else if (_bin_ucmp(a, b) >= 0) {
+		c = _bin_usub(a, b, c);
+		c->sign = as;
+	} else {
+		c = _bin_usub(b, a, c);
+		c->sign = bs;
+	}
+	return _bin_norm(c);
+}
+
+arb_bin *arb_bin_add(const arb_bin *a, const arb_bin *b, arb_bin *c)
+{
+	return _bin_addsign(a, b, b->sign, c);
+}
+
+arb_bin *arb_bin_sub(const arb_bin *a, const arb_bin *b, arb_bin *c)
+{
+	return _bin_addsign(a, b, b->sign == '-' ? '+' : '-', c);
+}
+
+arb_bin *arb_bin_mul(const arb_bin *a, const arb_bin *b, arb_bin *c)
+{
+	size_t n = a->n + b->n;
+	size_t i = 0;
+	size_t j = 0;
+	arb_limb *r = arb_calloc(n + 1, sizeof(arb_limb));
+	arb_dlimb p = 0;
+	char sign = a->sign == b->sign ? '+' : '-';
+
+	for (i = 0; i < a->n; ++i) {
+		arb_limb cy = 0;
+		for (j = 0; j < b->n; ++j) {
+			p = (arb_dlimb)a->limb[i] * b->limb[j] + r[i + j] + cy;
+			r[i + j] = (arb_limb)p;
+			cy = p >> ARB_LIMB_BITS;
+		}
+		r[i + j] = cy;
+	}
+	/* the product was formed on the side so 'c' may be 'a' or 'b' */
+	c = _bin_expand(c, 0);
+	arb_dealloc(c->limb);
+	c->limb = r;
+	c->allocated = n + 1;
+	c->n = n;
+	c->sign = sign;
+	return _bin_norm(c);
+}
+
+int arb_bin_cmp(const arb_bin *a, const arb_bin *b)
+{
+	if (a->sign != b->sign)
+		return a->sign == '-' ? -1 : 1;
+	return a->sign == '-' ? _bin_ucmp(b, a) : _bin_ucmp(a, b);
+}
+
+/* the largest power of the base that fits in a limb, and its exponent */
+static arb_limb _bin_chunk(int base, size_t *k)
+{
+	arb_limb pow = base;
+
+	for (*k = 1; pow <= (arb_limb)-1 / base; ++*k)
+		pow *= base;
+	return pow;
+}
+
+arb_bin *arb_bin_from(const fxdpnt *a, arb_bin *x, int base)
+{
+	fxdpnt tmp[1] = { 0 };
+	fxdpnt v[1] = { 0 };
+	const fxdpnt *f = arb_flat(a, tmp);
+	size_t k = 0;
+	size_t i = 0;
+	size_t j = 0;
+	size_t step = 0;
+
+	_bin_chunk(base, &k);
+	x = _bin_expand(x, f->lp / k + 2);
+	x->n = 0;
+	/* x = x * base^step + (the next 'step' digits) */
+	for (step = f->lp % k ? f->lp % k : k; i < f->lp; i += step, step = k) {
+		arb_limb chunk = 0;
+		arb_limb p = 1;
+		arb_dlimb t = 0;
+		for (j = 0; j < step; ++j) {
+			chunk = chunk * base + f->number[i + j];
+			p *= base;
+		}
+		for (j = 0; j < x->n; ++j) {
+			t = (arb_dlimb)x->limb[j] * p + chunk;
+			x->limb[j] = (arb_limb)t;
+			chunk = t >> ARB_LIMB_BITS;
+		}
+		if (chunk)
+			x->limb[x->n++] = chunk;
+	}
+	x->sign = f->sign;
+	x = _bin_norm(x);
+
+	/* keep the integer part of 'a' as the digit form of 'x' */
+	x->dec = arb_copy(NULL, arb_view(v, f, 0, f->lp, f->lp));
+	x->dec->sign = x->sign;
+	x->dec = remove_leading_zeros(x->dec);
+	x->dec_base = base;
+	arb_release(tmp);
+	return x;
+}
+
+static fxdpnt *_bin_digits(const arb_bin *x, int base)
+{
+	size_t k = 0;
+	arb_limb pow = _bin_chunk(base, &k);
+	size_t n = x->n;
+	size_t len = (n * ARB_LIMB_BITS) + k;
+	size_t pos = len;
+	size_t i = 0;
+	size_t j = 0;
+	arb_limb *t = arb_malloc((n + 1) * sizeof(arb_limb));
+	fxdpnt *c = arb_expand(NULL, len);
+
+	memcpy(t, x->limb, n * sizeof(arb_limb));
+	/* peel 'k' digits at a time off of the bottom */
+	while (n) {
+		arb_dlimb r = 0;
+		for (i = n; i--;) {
+			r = (r << ARB_LIMB_BITS) | t[i];
+			t[i] = (arb_limb)(r / pow);
+			r %= pow;
+		}
+		for (j = 0; j < k; ++j, r /= base)
+			c->number[--pos] = r % base;
+		while (n && !t[n - 1])
+			--n;
+	}
+	arb_dealloc(t);
+
+	if (pos == len)
+		c->number[--pos] = 0;
+	memmove(c->number, c->number + pos, (len - pos) * sizeof(UARBT));
+	c->lp = c->len = len - pos;
+	c->sign = x->sign;
+	return remove_leading_zeros(c);
+}
+
+static const fxdpnt *_bin_cached(const arb_bin *x, int base)
+{
+	/* the cache is not part of the value, so it may be filled in */
+	arb_bin *m = (arb_bin *)x;
+
+	if (m->dec == NULL || m->dec_base != base) {
+		arb_free(m->dec);
+		m->dec = _bin_digits(m, base);
+		m->dec_base = base;
+	}
+	return m->dec;
+}
+
+fxdpnt *arb_bin_to(const arb_bin *x, fxdpnt *c, int base)
+{
+	return arb_copy(c, _bin_cached(x, base));
+}
+
+void arb_bin_print(const arb_bin *x, int base)
+{
+	arb_print(_bin_cached(x, base));
+}
+
+void arb_bin_free(arb_bin *x)
+{
+	if (x) {
+		arb_free(x->dec);
+		arb_dealloc(x->limb);
+		arb_dealloc(x);
+	}
+}
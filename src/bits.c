@@ -0,0 +1,178 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	Bitwise operations for numbers in a base which is a power of two, such
+	as 2, 16 or 256. Each digit of such a number is a whole group of bits,
+	so the bits can be worked on with masks and shifts a digit at a time
+	without any division.
+
+	arb_and, arb_or and arb_xor line the digits of both operands up on the
+	radix, so the fractional digits take part too. They work on the
+	magnitudes of the operands and their results are positive.
+
+	arb_shl_bits multiplies by 2^n exactly. The whole digits of the shift
+	move the radix like arb_shift_radix does. arb_shr_bits divides by 2^n
+	and truncates the result to the scale of its input, like a hardware
+	shift drops the bits shifted out of a register.
+
+	Using any of these with a base that is not a power of two is an error.
+*/
+
+/* log2 of 'base' when it is a power of two, otherwise 0 */
+int arb_pow2base(int base)
+{
+	int k = 0;
+
+	if (base < 2 || (base & (base - 1)))
+		return 0;
+	while (base >>= 1)
+		++k;
+	return k;
+}
+
+static int _arb_bits(int base, const char *m)
+{
+	int k = arb_pow2base(base);
+
+	if (k == 0)
+		arb_error(m);
+	return k;
+}
+
+static UARBT _arb_digit(const fxdpnt *a, size_t lp, size_t i)
+{
+	/* digit 'i' of 'a' when lined up on a radix after 'lp' digits */
+	if (i + a->lp < lp || i + a->lp - lp >= a->len)
+		return 0;
+	return a->number[i + a->lp - lp];
+}
+
+#define ARB_AND 0
+#define ARB_OR 1
+#define ARB_XOR 2
+
+static fxdpnt *_arb_bitwise(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, int op)
+{
+	fxdpnt fa[1] = { 0 };
+	fxdpnt fb[1] = { 0 };
+	size_t lp = 0;
+	size_t len = 0;
+	size_t i = 0;
+	UARBT x = 0;
+	UARBT y = 0;
+
+	_arb_bits(base, "arb_and, arb_or and arb_xor need a base of 2^k");
+	a = arb_flat(a, fa);
+	b = arb_flat(b, fb);
+	lp = MAX(rl(a), rl(b));
+	len = lp + MAX(rr(a), rr(b));
+
+	fxdpnt *c2 = arb_expand(NULL, len);
+	for (i = 0; i < len; ++i) {
+		x = _arb_digit(a, lp, i);
+		y = _arb_digit(b, lp, i);
+		if (op == ARB_AND)
+			c2->number[i] = x & y;
+		else if (op == ARB_OR)
+			c2->number[i] = x | y;
+		else
+			c2->number[i] = x ^ y;
+	}
+	c2->lp = lp;
+	c2->len = len;
+	c2->sign = '+';
+	arb_release(fa);
+	arb_release(fb);
+	arb_free(c);
+	return remove_leading_zeros(c2);
+}
+
+fxdpnt *arb_and(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
+{
+	return _arb_bitwise(a, b, c, base, ARB_AND);
+}
+
+fxdpnt *arb_or(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
+{
+	return _arb_bitwise(a, b, c, base, ARB_OR);
+}
+
+fxdpnt *arb_xor(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
+{
+	return _arb_bitwise(a, b, c, base, ARB_XOR);
+}
+
+fxdpnt *arb_shl_bits(const fxdpnt *a, size_t n, fxdpnt *c, int base)
+{
+	int k = _arb_bits(base, "arb_shl_bits needs a base of 2^k");
+	size_t r = n % k;
+	size_t i = 0;
+	UARBT d = 0;
+	UARBT cy = 0;
+
+	if (c != a)
+		c = arb_copy(c, a);
+	c = arb_expand(c, c->len);
+
+	/* the bits within a digit, from the bottom up */
+	if (r) {
+		for (i = c->len; i > 0; cy = d >> (k - r)) {
+			d = c->number[--i];
+			c->number[i] = ((d << r) | cy) & (base - 1);
+		}
+		if (cy) {
+			c = arb_expand(c, c->len + 1);
+			memmove(c->number + 1, c->number, c->len * sizeof(UARBT));
+			c->number[0] = cy;
+			c->len++;
+			c->lp++;
+		}
+	}
+	/* and the whole digits */
+	c = arb_shift_radix(c, n / k);
+	return remove_leading_zeros(c);
+}
+
+fxdpnt *arb_shr_bits(const fxdpnt *a, size_t n, fxdpnt *c, int base)
+{
+	int k = _arb_bits(base, "arb_shr_bits needs a base of 2^k");
+	size_t r = n % k;
+	size_t q = n / k;
+	size_t scale = 0;
+	size_t i = 0;
+	UARBT d = 0;
+	UARBT lo = 0;
+
+	if (c != a)
+		c = arb_copy(c, a);
+	c = arb_flatten(arb_expand(c, c->len));
+	scale = rr(c);
+
+	/* the bits within a digit, from the top down. the lowest fall off */
+	if (r) {
+		for (i = 0; i < c->len; ++i, lo = d & ((1 << r) - 1)) {
+			d = c->number[i];
+			c->number[i] = (lo << (k - r)) | (d >> r);
+		}
+	}
+
+	/* and the whole digits, keeping the scale */
+	if (q <= c->lp) {
+		c->lp -= q;
+		c->len -= q;
+	} else if (q - c->lp >= scale) {
+		c->lp = c->len = 0;
+	} else {
+		size_t p = q - c->lp;
+		memmove(c->number + p, c->number, (scale - p) * sizeof(UARBT));
+		_arb_memset(c->number, 0, p);
+		c->lp = 0;
+		c->len = scale;
+	}
+	c = remove_leading_zeros(c);
+	if (c->sig == 0)
+		c->sign = '+';
+	return c;
+}
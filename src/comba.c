@@ -124,13 +124,14 @@ size_t arb_mul_comba_core(const UARBT *a, size_t alen, const UARBT *b, size_t bl
 
 fxdpnt *arb_comba(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, size_t scale)
 {
+	/* the stored digits are multiplied and the product takes the exponents */
 	fxdpnt *c2 = arb_expand(NULL,( a->len + b->len) * 10);
 	arb_setsign(a, b, c2);
         arb_mul_comba_core(a->number, a->len, b->number, b->len, c2->number, base);
         c2->lp = rl(a) + rl(b);
-        c2->len = MIN(rr(a) + rr(b), MAX(scale, MAX(rr(a), rr(b)))) + c2->lp;
+        c2->len = a->len + b->len;
+	c2 = arb_mul_exp(c2, a, b, scale);
         arb_free(c);
-	c2 = remove_leading_zeros(c2);
         return c2;
 }
 
@@ -12,14 +12,74 @@ static int is_trailing_zeros(const fxdpnt *a, size_t idx) {
 	return 1;
 }
 
+/* compare the magnitudes of two non-zero numbers in canonical form. the
+ * integer lengths decide first, then a single memcmp of the significant
+ * digits, see remove_leading_zeros()
+ */
+static long magnitude(const fxdpnt *a, size_t *pos) {
+	/* the position of the first significant digit relative to the radix,
+	 * purely fractional numbers are the smaller the more leading zeros
+	 */
+	*pos = 0;
+	if (a->lp)
+		return (long)a->lp + a->exp;
+	for (; !a->number[*pos]; ++*pos)
+		;
+	return a->exp - (long)*pos;
+}
+
+static int compare_canonical(const fxdpnt *a, const fxdpnt *b) {
+	size_t a_pos = 0;
+	size_t b_pos = 0;
+	size_t len = 0;
+	int result = 0;
+	long a_mag = magnitude(a, &a_pos);
+	long b_mag = magnitude(b, &b_pos);
+
+	if (a_mag != b_mag)
+		return a_mag > b_mag ? 1 : -1;
+
+	len = MIN(a->sig - a_pos, b->sig - b_pos);
+	result = memcmp(a->number + a_pos, b->number + b_pos, len * sizeof(UARBT));
+	if (result)
+		return result > 0 ? 1 : -1;
+	if (a->sig - a_pos != b->sig - b_pos)
+		return a->sig - a_pos > b->sig - b_pos ? 1 : -1;
+	return 0;
+}
+
 int arb_compare(const fxdpnt *a, const fxdpnt *b) {
 	size_t a_pos = 0;
 	size_t b_pos = 0;
 	int result = 0;
 
+	/* zero is neither positive nor negative */
+	if (iszero(a) == 0 || iszero(b) == 0) {
+		if (iszero(a) == 0 && iszero(b) == 0)
+			return 0;
+		if (iszero(a) == 0)
+			return b->sign == '-' ? 1 : -1;
+		return a->sign == '-' ? -1 : 1;
+	}
+
 	if (a->sign == '-' && b->sign == '+') return -1;
 	if (a->sign == '+' && b->sign == '-') return 1;
 
+	if (a->flags & b->flags & ARB_CANON) {
+		result = compare_canonical(a, b);
+		goto end;
+	}
+
+	/* the scan below needs flat numbers */
+	if (a->exp || b->exp) {
+		fxdpnt fa[1] = { 0 };
+		fxdpnt fb[1] = { 0 };
+		result = arb_compare(arb_flat(a, fa), arb_flat(b, fb));
+		arb_release(fa);
+		arb_release(fb);
+		return result;
+	}
+
 	/* This may be better implemented as a raw for-loop to avoid any extra
 	 * variable and function overhead in count_leading_zeros()
 	 */
@@ -47,9 +107,98 @@ int arb_compare(const fxdpnt *a, const fxdpnt *b) {
 			result = a->number[a_pos] - b->number[b_pos];
 	}
 
+	end:
 	if (a->sign == '-') {  // and also b->sign == '-'
 		result = 0 - result;
 	}
 
 	return result;
 }
+
+/* equality of canonical numbers is a length check and a memcmp */
+int arb_equal(const fxdpnt *a, const fxdpnt *b) {
+	if (!(a->flags & b->flags & ARB_CANON) || a->exp || b->exp)
+		return arb_compare(a, b) == 0;
+	if (a->sig == 0 || b->sig == 0)
+		return a->sig == b->sig;
+	return a->sign == b->sign && a->lp == b->lp && a->sig == b->sig &&
+		   !memcmp(a->number, b->number, a->sig * sizeof(UARBT));
+}
+
+/* arb_cmp_mul() compares a * b with c without forming a * b when it can
+ * help it. The positions of the leading digits settle most comparisons,
+ * as a product of numbers of m and n digits has m + n - 1 or m + n of
+ * them. Otherwise the leading digits of a and b, truncated and rounded
+ * up, bound the product from below and above, which settles it unless c
+ * falls between the bounds. Only then is the product multiplied out.
+ */
+
+/* the first 'k' significant digits of 'a' as an integer, and whether
+ * there are more nonzero digits after them
+ */
+static uint64_t lead(const fxdpnt *a, size_t z, size_t t, size_t k, int base, int *more) {
+	uint64_t v = 0;
+	size_t i = 0;
+
+	for (; i < k; ++i)
+		v = v * base + (z + i < t ? a->number[z + i] : 0);
+	*more = t - z > k;
+	return v;
+}
+
+/* the count of fractional digits of 'a' */
+static size_t frac(const fxdpnt *a) {
+	long s = (long)rr(a) - a->exp;
+	return s > 0 ? s : 0;
+}
+
+int arb_cmp_mul(const fxdpnt *a, const fxdpnt *b, const fxdpnt *c, int base) {
+	size_t za = 0, ta = 0, zb = 0, tb = 0, zc = 0, tc = 0;
+	long pa = arb_span(a, &za, &ta);
+	long pb = arb_span(b, &zb, &tb);
+	long pc = arb_span(c, &zc, &tc);
+	int neg = (a->sign == '-') != (b->sign == '-');
+	int sign = 0;
+	int ma = 0, mb = 0, mc = 0;
+	uint64_t al = 0, bl = 0, cl = 0, bk = 1;
+	size_t k = 1;
+	fxdpnt *t = NULL;
+	int result = 0;
+
+	/* the signs, with zero being neither positive nor negative */
+	if (za == ta || zb == tb)
+		return zc == tc ? 0 : c->sign == '-' ? 1 : -1;
+	if (zc == tc)
+		return neg ? -1 : 1;
+	if (neg != (c->sign == '-'))
+		return neg ? -1 : 1;
+	sign = neg ? -1 : 1;
+
+	/* the product is at least base^(pa + pb - 2) and below base^(pa + pb) */
+	if (pc > pa + pb)
+		return -sign;
+	if (pc < pa + pb - 1)
+		return sign;
+
+	/* the 'k' leading digits of a and b and the 2k of c, with their
+	 * products and base^2k fitting a word
+	 */
+	for (; bk <= UINT64_MAX / base / base / base / base; bk *= base * base)
+		++k;
+	al = lead(a, za, ta, k, base, &ma);
+	bl = lead(b, zb, tb, k, base, &mb);
+	cl = lead(c, zc, tc, 2 * k - (pa + pb - pc), base, &mc);
+	if ((al + ma) * (bl + mb) <= cl && (ma || mb || mc || al * bl < cl))
+		return -sign;
+	if (al * bl >= cl + mc && (ma || mb || mc || al * bl > cl))
+		return sign;
+
+	t = arb_mul(a, b, NULL, base, frac(a) + frac(b));
+	result = arb_compare(t, c);
+	arb_free(t);
+	return (result > 0) - (result < 0);
+}
+
+int arb_cmp_sqr(const fxdpnt *a, const fxdpnt *c, int base) {
+	return arb_cmp_mul(a, a, c, base);
+}
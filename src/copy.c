@@ -2,19 +2,80 @@
 
 /* Copyright 2017-2019 CM Graff */
 
+/*
+	arb_copy() normally duplicates the digits of a number. When the
+	copy-on-write mode is enabled with arb_set_cow(1) it instead shares them
+	through arb_share() which is O(1) regardless of the size of the number.
+
+	Shared digits carry a reference count. The first operation which writes
+	to a shared number gives it a private copy of its digits (see
+	arb_expand_inter) and the last owner frees them. The reference count is
+	not atomic, so shared numbers must not be used by more than one thread.
+*/
 
 void _arb_copy_core(UARBT *b, UARBT *a, size_t len)
 {
 	memcpy(b, a, len * sizeof(UARBT));
 }
 
-fxdpnt *arb_copy(fxdpnt *b, const fxdpnt *a)
-{ 
+fxdpnt *_arb_copy_digits(fxdpnt *b, const fxdpnt *a)
+{
 	b = arb_expand(b, a->len);
 	b->len = a->len;
 	b->lp = a->lp;
 	b->sign = a->sign;
+	b->exp = a->exp;
+	b->flags |= a->flags & ARB_CANON;
+	b->sig = a->sig;
 	_arb_copy_core(b->number, a->number, a->len);
 	return b;
 }
 
+fxdpnt *arb_share(fxdpnt *b, const fxdpnt *a)
+{
+	fxdpnt *m = (fxdpnt *)a; /* only the reference count is modified */
+
+	if (b == a)
+		return b;
+	/* the digits of a view are not a's to share */
+	if (a->flags & ARB_VIEW)
+		return _arb_copy_digits(b, a);
+
+	if (b == NULL) {
+		b = arb_malloc(sizeof(fxdpnt));
+		b->number = NULL;
+		b->flags = 0;
+		b->refs = NULL;
+	}
+	arb_release(b);
+
+	if (!m->refs) {
+		m->refs = arb_malloc(sizeof(size_t));
+		*m->refs = 1;
+	}
+	++*m->refs;
+	b->refs = m->refs;
+	b->number = m->number;
+	b->allocated = m->allocated;
+	b->flags = a->flags & ARB_CANON;
+	b->sig = a->sig;
+	b->len = a->len;
+	b->lp = a->lp;
+	b->sign = a->sign;
+	b->exp = a->exp;
+	return b;
+}
+
+fxdpnt *arb_copy(fxdpnt *b, const fxdpnt *a)
+{ 
+	if (_arb_cow)
+		return arb_share(b, a);
+	return _arb_copy_digits(b, a);
+}
+
+int arb_set_cow(int on)
+{
+	int old = _arb_cow;
+	_arb_cow = on;
+	return old;
+}
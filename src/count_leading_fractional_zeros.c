@@ -2,20 +2,28 @@
 
 /* Copyright CM Graff 2019 */
 
-size_t count_leading_fractional_zeros(fxdpnt *a)
+size_t count_leading_fractional_zeros(const fxdpnt *a)
 {
 	size_t pos = a->lp;
 	size_t ret = 0;
+
+	/* leading zeros may be held in the exponent */
+	if (a->exp) {
+		fxdpnt tmp[1] = { 0 };
+		ret = count_leading_fractional_zeros(arb_flat(a, tmp));
+		arb_release(tmp);
+		return ret;
+	}
+
 	if (a->lp == 1 && a->number[0] == 0)
 		;
 	else if (a->lp > 0) {
 		return 0;
 	}
-	while (a->number[pos] == 0) {
+	while (pos < a->len && a->number[pos] == 0) {
 		pos++;
 		ret++;
 	}
 	return ret;
 }
 
-
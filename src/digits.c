@@ -0,0 +1,61 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	arb_export_digits() and arb_import_digits() move the digits of a
+	number in and out of a plain array, most significant digit first, for
+	callers which keep numbers in their own fixed layout such as the
+	arb::fixed types of arbitraire.hpp.
+
+	arb_export_digits() lines the digits of 'a' up so that 'lp' of them are
+	left of the radix and 'scale' are right of it, padding with zeros and
+	truncating any fractional digits past the scale. It returns -1 when
+	the integer part of 'a' does not fit in 'lp' digits and 0 otherwise.
+
+	arb_import_digits() makes a number from 'len' digits with the radix
+	after 'lp' of them. The first argument may be NULL or a number to be
+	written over.
+*/
+
+int arb_export_digits(const fxdpnt *a, unsigned char *out, size_t lp, size_t scale, char *sign)
+{
+	fxdpnt tmp[1] = { 0 };
+	const fxdpnt *f = arb_flat(a, tmp);
+	size_t skip = 0;
+	size_t i = 0;
+	int ret = 0;
+
+	/* leading zeros do not count against the integer digits */
+	for (; skip < f->lp && !f->number[skip]; ++skip)
+		;
+	if (f->lp - skip > lp) {
+		ret = -1;
+		goto end;
+	}
+
+	_arb_memset(out, 0, lp + scale);
+	for (i = skip; i < f->lp; ++i)
+		out[lp - (f->lp - i)] = f->number[i];
+	for (i = 0; i < scale && f->lp + i < f->len; ++i)
+		out[lp + i] = f->number[f->lp + i];
+	if (sign)
+		*sign = f->sign;
+	end:
+	arb_release(tmp);
+	return ret;
+}
+
+fxdpnt *arb_import_digits(fxdpnt *c, const unsigned char *digits, size_t len, size_t lp, char sign)
+{
+	c = arb_expand(c, len);
+	arb_init(c);
+	memcpy(c->number, digits, len * sizeof(UARBT));
+	c->len = len;
+	c->lp = lp;
+	c->sign = sign;
+	c = remove_leading_zeros(c);
+	if (c->sig == 0)
+		c->sign = '+';
+	return c;
+}
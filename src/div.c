@@ -1,5 +1,7 @@
 #include "internal.h"
 
+#include <pthread.h>
+
 /* Copyright 2017-2019 CM Graff */
 
 
@@ -37,13 +39,23 @@
 	
 	see src/modulo.c for this operation.
 
-	This algorithm deviates from Knuth's method by fusing the normalization 
-	and temporary variable copy downs. This does not optimize the case of a 
-	normalization factor of (1) but instead trades it off for a smaller code
-       	footprint.
+	This algorithm deviates from Knuth's method by fusing the normalization
+	and temporary variable copy downs. A normalization factor of (1) skips
+	both, and the divisor is then read in place.
+
+	Each quotient digit is estimated from the top three digits of the
+	remainder and the top two digits of the divisor, as with a 3-by-2
+	division. The reciprocal of the top two divisor digits is found once,
+	after normalization, so the estimate costs a multiplication and a
+	shift instead of a hardware divide. It is at most one too small, which
+	one comparison corrects, and it is then exactly the guess which D3's
+	two tests would have reached.
+
+	arb_div() hands the denominator over as a whole number without its
+	trailing zeros, and moves the radix of the numerator to make up for
+	it, so 1500000000 or 2.5000000 cost as much as 15 or 25.
 
 	TODO: don't exit on zero
-	TODO: strip trailing zeros from the denominator
 
 
 	History:
@@ -51,68 +63,166 @@
 	1600
 */
 
-int _long_sum(UARBT *u, size_t i, const UARBT *v, size_t k, int b, uint8_t lever)
+/* the reciprocal of 'd' for _arb_div_3by2, 'd' being less than base^2 */
+static uint64_t _arb_div_recip(uint64_t d)
+{
+	return (1ULL << 32) / d;
+}
+
+/* the quotient of the 3 digit 'n' by the 2 digit 'd', at most 'b' - 1.
+   'n' is below base^3 and so below 2^24, which makes the estimate from
+   the truncated reciprocal fall short by less than one */
+static UARBT _arb_div_3by2(uint64_t n, uint64_t d, uint64_t inv, int b)
+{
+	uint64_t q = (n * inv) >> 32;
+
+	if (n - q * d >= d)
+		++q;
+	return MIN(q, (uint64_t)b - 1);
+}
+
+/* u[0..n] -= q * v[0..n-1], in one pass from the lowest digit up. Returns
+   1 if the result went negative, in which case 'u' holds its complement.
+   A base of 2^bits splits the products with a shift and a mask */
+static int _arb_submul(UARBT *u, const UARBT *v, size_t n, UARBT q, int b, int bits)
 {
-	uint8_t carrborr = 0;
-	ARBT val = 0;
-	for (;k+1 > 0; i--, k--) {
-		/* addition */
-		if (lever == 0) {
-			val = u[i] + v[k] + carrborr;
-			carrborr = 0;
-			if (val >= b) {
-				val -= b;
-				carrborr = 1;
-			}
-		/* subtraction */
-		}else {
-			val = u[i] - v[k] - carrborr; 
-			carrborr = 0;
-			if (val < 0) {
-				val += b;
-				carrborr = 1;
-			}
+	unsigned mask = (1u << bits) - 1;
+	unsigned k = 0;
+	unsigned p = 0;
+	int t = 0;
+
+	for (; n > 0; --n) {
+		p = q * v[n - 1] + k;
+		if (bits) {
+			k = p >> bits;
+			t = u[n] - (int)(p & mask);
+		} else {
+			k = p / b;
+			t = u[n] - (int)(p % b);
+		}
+		if (t < 0) {
+			t += b;
+			++k;
 		}
-		u[i] = val;
+		u[n] = t;
+	}
+	t = u[0] - (int)k;
+	u[0] = t < 0 ? t + b : t;
+	return t < 0;
+}
+
+/* u[1..n] += v[0..n-1], which undoes one too many subtractions of 'v' by
+   _arb_submul. The carry out of u[1] cancels the borrow left in u[0] */
+static void _arb_addback(UARBT *u, const UARBT *v, size_t n, int b)
+{
+	unsigned k = 0;
+	unsigned t = 0;
+
+	for (; n > 0; --n) {
+		t = u[n] + v[n - 1] + k;
+		k = t >= (unsigned)b;
+		u[n] = k ? t - b : t;
+	}
+	u[0] = 0;
+}
+
+typedef struct {
+	UARBT *d;
+	size_t n;
+} arb_div_space;
+
+static pthread_key_t _arb_div_key;
+static pthread_once_t _arb_div_once = PTHREAD_ONCE_INIT;
+
+static void _arb_div_space_free(void *p)
+{
+	arb_div_space *w = p;
+
+	if (!w)
+		return;
+	arb_dealloc(w->d);
+	arb_dealloc(w);
+}
+
+static void _arb_div_init(void)
+{
+	pthread_key_create(&_arb_div_key, _arb_div_space_free);
+	/* key destructors never run for the main thread */
+	atexit(arb_div_space_free);
+}
+
+/* this thread's division workspace, at least 'n' digits long and not
+   zeroed. It is kept between divisions and freed when the thread exits,
+   or for the thread which calls exit(), at exit */
+static UARBT *_arb_div_space(size_t n)
+{
+	arb_div_space *w = NULL;
+
+	pthread_once(&_arb_div_once, _arb_div_init);
+	if (!(w = pthread_getspecific(_arb_div_key))) {
+		w = arb_calloc(1, sizeof(arb_div_space));
+		pthread_setspecific(_arb_div_key, w);
+	}
+	if (w->n < n) {
+		arb_dealloc(w->d);
+		w->n = MAX(n, w->n * 2);
+		w->d = arb_malloc(w->n * sizeof(UARBT));
 	}
-	return carrborr;
+	return w->d;
+}
+
+void arb_div_space_free(void)
+{
+	pthread_once(&_arb_div_once, _arb_div_init);
+	_arb_div_space_free(pthread_getspecific(_arb_div_key));
+	pthread_setspecific(_arb_div_key, NULL);
 }
 
 fxdpnt *arb_div_inter(const fxdpnt *num, const fxdpnt *den, fxdpnt *q, int b, size_t scale)
 {
 	UARBT *u = NULL;
 	UARBT *v = NULL;
-	UARBT *vf = NULL;
-	UARBT *temp = NULL;
 	UARBT *p = NULL;
 	UARBT qg = 0;
 	UARBT norm = 0;
 	size_t lea = 0;
 	size_t leb = 0;
+	size_t un = 0;
 	size_t i = 0;
 	size_t j = 0;
+	uint64_t d = 0;
+	uint64_t inv = 0;
+	int bits = arb_pow2base(b);
 
 	if (iszero(den) == 0) {
 		fputs("Divide by zero\n", stderr);
 		return NULL;
 	}
 
-	/* temporary storage and storage for normalized den and num */
-	u = arb_calloc(1, (num->len + rr(den) + 3 + scale) * sizeof(UARBT));
-	vf = v = arb_calloc(1, (den->len + rr(num) + 3 + scale) * sizeof(UARBT));
-	temp = arb_malloc((den->len+1) * sizeof(UARBT)); 
 	p = den->number;
 	leb = den->len;
 
 	/* find the first real value for normalization (strip zeros) */
 	for (;!*p; p++, leb--);
 
+	/* storage for the normalized num, and den when it is not read in place */
+	un = num->len + rr(den) + 3 + scale;
+	u = _arb_div_space(un + leb + 1);
+	memset(u, 0, un * sizeof(UARBT));
+
 	/* normalization is fused with copy down to temporary storage */
 	norm = (b / (p[0] + 1));
-	arb_mul_core(num->number, num->len, &norm, 1, u, b);
-	arb_mul_core(p, leb, &norm, 1, v, b);
-	if (!*v) /* deal with a possible zero from arb_mul_core */
-		v++;
+	if (norm == 1) {
+		memcpy(u + 1, num->number, num->len * sizeof(UARBT));
+		v = p;
+	} else {
+		v = u + un;
+		memset(v, 0, (leb + 1) * sizeof(UARBT));
+		arb_mul_core(num->number, num->len, &norm, 1, u, b);
+		arb_mul_core(p, leb, &norm, 1, v, b);
+		if (!*v) /* deal with a possible zero from arb_mul_core */
+			v++;
+	}
 
 	/* compute the scales for the final solution */
 	lea = rl(num) + rr(den);
@@ -130,41 +240,119 @@ fxdpnt *arb_div_inter(const fxdpnt *num, const fxdpnt *den, fxdpnt *q, int b, si
 	if (leb > lea)
 		j = (leb-lea);
 
-	for (qg = b-1;i <= lea+scale-leb; ++i, ++j, qg = b-1) {
-		if (v[0] != u[i])
-			qg = (u[i]*b + u[i+1]) / v[0];
-		/* early guesses */
-		if (v[1] * qg > (u[i] * b + u[i+1] - v[0] * qg) * b + u[i+2]) {
-			qg = qg - 1;
-			if (v[1] * qg > (u[i] * b + u[i+1] - v[0] * qg) * b + u[i+2])
-				qg = qg - 1;
-		} 
+	d = (uint64_t)v[0] * b + (leb > 1 ? v[1] : 0);
+	inv = _arb_div_recip(d);
+	for (;i <= lea+scale-leb; ++i, ++j) {
+		/* D3, the guess */
+		qg = _arb_div_3by2(((uint64_t)u[i] * b + u[i+1]) * b + u[i+2], d, inv, b);
 		/* D4. [Multiply and Subtract] */
-		if (qg != 0) {
-			arb_mul_core(v, leb, &qg, 1, temp, b);
-			if (!(_long_sum(u+leb, i, temp, leb, b, 1)))
-				goto D7;
+		if (qg != 0 && _arb_submul(u + i, v, leb, qg, b, bits)) {
+			/* D6. [Add back] */
 			qg = qg - 1;
-			if (_long_sum(u+leb, i, v, leb-1, b, 0))
-				u[0] = 0;
+			_arb_addback(u + i, v, leb, b);
 		}
-		D7: /* D7 */
 		q->number[j] = qg;
 	}
 	end:
 	q = remove_leading_zeros(q);
-	free(temp);
-	free(u);
-	free(vf);
 	return q;
 }
 
-fxdpnt *arb_div(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, size_t scale)
+/* a new quotient of 'a' by 'b', which the caller frees 'c' after */
+static fxdpnt *_arb_div(const fxdpnt *a, const fxdpnt *b, int base, size_t scale)
 {
-	fxdpnt *c2 = arb_expand(NULL, a->len + b->len + scale);
+	fxdpnt fa[1] = { 0 };
+	fxdpnt fb[1] = { 0 };
+	fxdpnt as[1] = { 0 };
+	fxdpnt bs[1] = { 0 };
+	fxdpnt *c2 = NULL;
+	size_t za = 0;
+	size_t ta = 0;
+	size_t zb = 0;
+	size_t tb = 0;
+	long e = 0;
+	long s = 0;
+	long t = 0;
+
+	/* a / b is (a * base^-e) / (b * base^-e), where base^e is the place of
+	   the lowest significant digit of b, which leaves b a whole number
+	   without trailing zeros */
+	zb = tb = 0;
+	e = arb_span(b, &zb, &tb);
+	e -= (long)(tb - zb);
+	if (zb == tb) {
+		a = arb_flat(a, fa);
+		b = arb_flat(b, fb);
+		c2 = arb_expand(NULL, a->len + b->len + scale);
+		arb_init(c2);
+		arb_setsign(a, b, c2);
+		c2 = arb_div_inter(a, b, c2, base, scale);
+		goto end;
+	}
+	arb_view(bs, b, zb, tb - zb, tb - zb);
+	b = bs;
+
+	/* a * base^-e is the stored digits of a times base^e, which are
+	   divided on their own, to the 's' places that the quotient needs
+	   before base^e moves it to 'scale' places. When 's' is below zero
+	   the stored digits are moved right by the difference first */
+	e = a->exp - e;
+	s = (long)scale + e;
+	t = MIN(s, 0);
+
+	/* a divisor of one is a power of the base, and only moves the radix */
+	if (b->len == 1 && b->number[0] == 1) {
+		c2 = arb_expand(NULL, a->len);
+		arb_setsign(a, b, c2);
+		memcpy(c2->number, a->number, a->len * sizeof(UARBT));
+		c2->lp = a->lp;
+		c2->len = a->len;
+		c2->exp = e;
+		c2 = arb_compress(arb_cut(c2, scale));
+		goto end;
+	}
+
+	/* moved right, digits which all fall below the divisor leave zero */
+	if (t < 0 && arb_span(a, &za, &ta) - a->exp + t < (long)b->len) {
+		c2 = arb_cut(arb_from_u64(0, NULL, base), scale);
+		goto end;
+	}
+
+	arb_view(as, a, 0, a->len, a->lp);
+	as->exp = t;
+	a = arb_flat(as, fa);
+	c2 = arb_expand(NULL, a->len + b->len + MAX(s, 0));
 	arb_init(c2);
 	arb_setsign(a, b, c2);
-	c2 = arb_div_inter(a, b, c2, base, scale);
+	c2 = arb_div_inter(a, b, c2, base, MAX(s, 0));
+	c2->exp = e - t;
+	c2 = arb_compress(c2);
+	end:
+	arb_release(fa);
+	arb_release(fb);
+	return c2;
+}
+
+/* the library's own divisions go through here, so that only the calls of
+   the program are cached */
+fxdpnt *arb_div_nomemo(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, size_t scale)
+{
+	fxdpnt *c2 = _arb_div(a, b, base, scale);
+
+	arb_free(c);
+	return c2;
+}
+
+fxdpnt *arb_div(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, size_t scale)
+{
+	fxdpnt *hit = NULL;
+	fxdpnt *c2 = NULL;
+
+	if (_arb_memo_budget && (hit = arb_memo_get(ARB_MEMO_DIV, a, b, base, scale, c)))
+		return hit;
+	c2 = _arb_div(a, b, base, scale);
+	if (_arb_memo_budget)
+		arb_memo_put(ARB_MEMO_DIV, a, b, base, scale, c2);
 	arb_free(c);
 	return c2;
 }
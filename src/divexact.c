@@ -0,0 +1,145 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	arb_divexact() divides 'a' by 'b' when the caller knows that the
+	quotient is an integer, such as when cancelling a common factor out of
+	a fraction. If it is not, the result is meaningless.
+
+	The quotient is found from its lowest digit up, by Hensel's method,
+	rather than from its highest digit down, as with Algorithm D. As
+	q * b = a, the lowest digit of q times the lowest digit of b matches
+	the lowest digit of a, so each digit of q is a multiplication by the
+	inverse of the lowest digit of b, modulo the base. There is nothing to
+	estimate and nothing to correct. Each column of q * b is summed in a
+	word and only its carry is divided by the base, and only the columns
+	below the length of q are needed, which is about half of the digit
+	products of a division when q and b are the same length.
+
+	The lowest digit of b needs an inverse modulo the base. Trailing zeros
+	are dropped from b by its span, and any factor that its lowest digit
+	shares with the base (2 and 5 in base 10) is divided out of both a
+	and b first, a word sized power at a time.
+*/
+
+/* the smallest prime which divides both 'd' and 'base', or 0 */
+static size_t _arb_divexact_common(size_t d, int base)
+{
+	size_t p = 2;
+
+	for (; p <= d; ++p)
+		if (d % p == 0 && base % p == 0)
+			return p;
+	return 0;
+}
+
+/* divide the largest power of 'p' which divides 'b' and fits in a word
+   out of both 'a' and 'b' */
+static void _arb_divexact_strip(fxdpnt **a, fxdpnt **b, size_t p, int base)
+{
+	size_t f = 1;
+	size_t r = 0;
+
+	for (; f <= SIZE_MAX / base / p; f *= p)
+		;
+	/* b mod p^k is divisible by the same power of p as b is, up to p^k */
+	arb_free(arb_divmod_ui(*b, f, NULL, &r, base, 0));
+	if (r)
+		for (f = 1; r % p == 0; r /= p)
+			f *= p;
+	*a = remove_leading_zeros(arb_divmod_ui(*a, f, *a, NULL, base, 0));
+	*b = remove_leading_zeros(arb_divmod_ui(*b, f, *b, NULL, base, 0));
+}
+
+/* the 'qn' lowest digits of a / b, by columns from the lowest up. 'a',
+   'b' and 'q' are little endian */
+static void _arb_hensel(const UARBT *a, const UARBT *b, size_t m, UARBT *q, size_t qn, int base)
+{
+	uint64_t acc = 0;
+	size_t inv = 1;
+	size_t i = 0;
+	size_t j = 0;
+	size_t d = 0;
+
+	for (; (b[0] * inv) % base != 1; ++inv)
+		;
+	for (; i < qn; ++i) {
+		/* the carry plus the products of the known digits of q */
+		for (j = 1; j <= i && j < m; ++j)
+			acc += (uint64_t)q[i - j] * b[j];
+		d = (a[i] + base - acc % base) % base;
+		q[i] = (d * inv) % base;
+		acc = (acc + (uint64_t)q[i] * b[0]) / base;
+	}
+}
+
+fxdpnt *arb_divexact(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
+{
+	size_t za = 0;
+	size_t ta = 0;
+	size_t zb = 0;
+	size_t tb = 0;
+	long pa = arb_span(a, &za, &ta);
+	long pb = arb_span(b, &zb, &tb);
+	long pad = (pa - (long)(ta - za)) - (pb - (long)(tb - zb));
+	char sign = a->sign == b->sign ? '+' : '-';
+	fxdpnt *x = NULL;
+	fxdpnt *y = NULL;
+	UARBT *al = NULL;
+	UARBT *bl = NULL;
+	UARBT *q = NULL;
+	size_t n = 0;
+	size_t m = 0;
+	size_t qn = 0;
+	size_t i = 0;
+	size_t p = 0;
+
+	if (zb == tb) {
+		fputs("Divide by zero\n", stderr);
+		return NULL;
+	}
+	/* a whole quotient of nonzero numbers means b has no more trailing
+	   zeros than a */
+	if (za == ta || pad < 0)
+		return arb_from_span(c, NULL, 0, 0, '+');
+
+	/* the significant digits as integers, with the zeros between them */
+	x = arb_from_span(NULL, a->number + za, ta - za, ta - za, '+');
+	x = arb_shift_radix(x, pad);
+	x = arb_flatten(x);
+	y = arb_from_span(NULL, b->number + zb, tb - zb, tb - zb, '+');
+	y = arb_flatten(y);
+	while ((p = _arb_divexact_common(y->number[y->len - 1], base)))
+		_arb_divexact_strip(&x, &y, p, base);
+
+	n = x->len;
+	m = y->len;
+	if (n < m) {
+		arb_free(x);
+		arb_free(y);
+		return arb_from_span(c, NULL, 0, 0, '+');
+	}
+	qn = n - m + 1;
+	al = arb_malloc(qn * sizeof(UARBT));
+	bl = arb_malloc(m * sizeof(UARBT));
+	q = arb_malloc(qn * sizeof(UARBT));
+	for (i = 0; i < qn; ++i)
+		al[i] = x->number[n - 1 - i];
+	for (i = 0; i < m; ++i)
+		bl[i] = y->number[m - 1 - i];
+	_arb_hensel(al, bl, m, q, qn, base);
+
+	/* back to big endian, in the place of the low digits of a */
+	for (i = 0; i < qn; ++i)
+		al[i] = q[qn - 1 - i];
+	for (i = 0; i + 1 < qn && !al[i]; ++i)
+		;
+	c = arb_from_span(c, al + i, qn - i, qn - i, sign);
+	arb_dealloc(al);
+	arb_dealloc(bl);
+	arb_dealloc(q);
+	arb_free(x);
+	arb_free(y);
+	return c;
+}
@@ -0,0 +1,197 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	A number's value is its digits, with the radix after 'lp' of them,
+	scaled by base^exp. This lets long runs of leading fractional zeros and
+	trailing integer zeros go unstored, as in 0.000...000123 or 1000...000.
+	The scale of such a number (its count of fractional digits) is
+	rr(a) - exp, or zero when that is negative.
+
+	Most kernels work on flat numbers (exp == 0). arb_flat() hands them a
+	flat version of an operand, which is only a view when the radix can be
+	moved within the stored digits and a padded copy otherwise. arb_align()
+	does the same for an arbitrary power of the base, which arb_add2 and
+	arb_sub2 use to line up two operands on their smaller exponent.
+
+	The temporary passed to arb_flat() and arb_align() must be zeroed and
+	released with arb_release() once the returned number is no longer used.
+
+	Multiplication and division work on the stored digits and add or
+	subtract the exponents instead. arb_cut() then drops the digits which
+	the flat result would not have kept at its scale, so 3 * 1e2000000 or
+	3 / 1e2000000 cost as much as 3 * 1 or 3 / 1.
+*/
+
+static void _arb_pad(fxdpnt *a, size_t lead, size_t tail)
+{
+	size_t len = a->len;
+	a = arb_expand(a, len + lead + tail);
+	if (lead) {
+		memmove(a->number + lead, a->number, len * sizeof(UARBT));
+		_arb_memset(a->number, 0, lead);
+	}
+	_arb_memset(a->number + lead + len, 0, tail);
+	a->len = len + lead + tail;
+}
+
+/* materialize the exponent of 'a' into its digits */
+fxdpnt *arb_flatten(fxdpnt *a)
+{
+	long r = (long)a->lp + a->exp;
+
+	if (a->exp == 0)
+		return a;
+	if (r < 0) {
+		_arb_pad(a, -r, 0);
+		a->lp = 0;
+	} else if ((size_t)r > a->len) {
+		_arb_pad(a, 0, r - a->len);
+		a->lp = r;
+	} else {
+		a->lp = r;
+	}
+	a->exp = 0;
+	return a;
+}
+
+const fxdpnt *arb_align(const fxdpnt *a, long exp, fxdpnt *tmp)
+{
+	long r = (long)a->lp + exp;
+
+	if (exp == 0 && a->exp == 0)
+		return a;
+	if (r >= 0 && (size_t)r <= a->len) {
+		arb_view(tmp, a, 0, a->len, r);
+		tmp->exp = 0;
+		return tmp;
+	}
+	tmp = arb_copy(tmp, a);
+	tmp->exp = exp;
+	return arb_flatten(tmp);
+}
+
+const fxdpnt *arb_flat(const fxdpnt *a, fxdpnt *tmp)
+{
+	return arb_align(a, a->exp, tmp);
+}
+
+/* move runs of zeros that are at least ARB_ZERO_RUN long into the exponent */
+fxdpnt *arb_compress(fxdpnt *a)
+{
+	size_t z = 0;
+
+	a = remove_leading_zeros(a);
+	if (a->sig == 0 || a->exp)
+		return a;
+
+	if (a->lp == 0) {
+		for (; !a->number[z]; ++z)
+			;
+		if (z >= ARB_ZERO_RUN) {
+			a = arb_leftshift(a, z);
+			a->len -= z;
+			a->exp = -(long)z;
+		}
+	} else if (a->lp == a->len && a->len - a->sig >= ARB_ZERO_RUN) {
+		z = a->len - a->sig;
+		a->len -= z;
+		a->lp -= z;
+		a->exp = z;
+	}
+	return remove_leading_zeros(a);
+}
+
+/* the count of fractional digits of the flat form of 'a' */
+size_t arb_rr(const fxdpnt *a)
+{
+	long r = (long)rr(a) - a->exp;
+
+	return r > 0 ? (size_t)r : 0;
+}
+
+/* cut 'c' after its digit of weight base^-k, or pad it with zeros up to
+   that digit, as a flat number is set to a scale of k */
+fxdpnt *arb_cut(fxdpnt *c, size_t k)
+{
+	long n = 0;
+
+	/* a zero has no use for an exponent */
+	if (iszero(c) == 0)
+		c->exp = 0;
+	n = (long)c->lp + c->exp + (long)k;
+	c->flags &= ~ARB_CANON;
+	if (arb_rr(c) < k) {
+		_arb_pad(c, 0, n - c->len);
+	} else if (n >= (long)c->len) {
+		return c;
+	} else if (n <= 0) {
+		/* nothing is left but a zero at the same scale */
+		c->number[0] = 0;
+		c->len = c->lp = 1;
+		c->exp = 0;
+		_arb_pad(c, 0, k);
+	} else if (n < (long)c->lp) {
+		/* the digits left are all before the radix, which moves to the
+		   end of them */
+		c->exp += (long)c->lp - n;
+		c->len = c->lp = n;
+	} else {
+		c->len = n;
+	}
+	return c;
+}
+
+/* 'c' is the product of the stored digits of 'a' and 'b'. It takes the sum
+   of their exponents and keeps the fractional digits that arb_mul2 keeps
+   for their flat forms at 'scale' */
+fxdpnt *arb_mul_exp(fxdpnt *c, const fxdpnt *a, const fxdpnt *b, size_t scale)
+{
+	size_t ra = arb_rr(a);
+	size_t rb = arb_rr(b);
+
+	c->exp = a->exp + b->exp;
+	c = arb_cut(c, MIN(ra + rb, MAX(scale, MAX(ra, rb))));
+	return arb_compress(c);
+}
+
+/* the significant digits of 'a' are number[*z] to number[*t - 1] */
+long arb_span(const fxdpnt *a, size_t *z, size_t *t)
+{
+	*t = a->flags & ARB_CANON ? a->sig : a->len;
+	for (; *t && !a->number[*t - 1]; --*t)
+		;
+	for (*z = 0; *z < *t && !a->number[*z]; ++*z)
+		;
+	/* the power of the base just above the leading digit */
+	return (long)a->lp + a->exp - (long)*z;
+}
+
+/* the number .d[0]d[1]...d[n - 1] * base^pos, with no trailing fractional
+   zeros and its zero runs handled like arb_compress() does. 'd' may be
+   the digits of 'c' */
+fxdpnt *arb_from_span(fxdpnt *c, const UARBT *d, size_t n, long pos, char sign)
+{
+	c = arb_expand(c, n ? n : 1);
+	arb_init(c);
+	if (n == 0) {
+		c->number[0] = 0;
+		c->lp = c->len = 1;
+		return remove_leading_zeros(c);
+	}
+	memmove(c->number, d, n * sizeof(UARBT));
+	c->len = n;
+	c->sign = sign;
+	if (pos < 0) {
+		c->exp = pos;
+	} else if ((size_t)pos > n) {
+		c->lp = n;
+		c->exp = pos - n;
+	} else {
+		c->lp = pos;
+	}
+	if (labs(c->exp) < ARB_ZERO_RUN)
+		c = arb_flatten(c);
+	return remove_leading_zeros(c);
+}
@@ -0,0 +1,444 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	arb_float is a floating point number with a fixed count of significant
+	digits, its precision, rather than bc's fixed count of fractional
+	digits. 1e-4000 / 3 at a precision of 100 has 100 digits, without a
+	scale of 4100, and a long chain of products does not grow its
+	operands. The value is held in an fxdpnt, whose exponent stores the
+	zeros between the digits and the radix.
+
+	The output of every operation may be NULL, in which case it is
+	allocated with the larger precision of the operands and the base of
+	the first, or may be the same as either input. Otherwise the result is
+	rounded to the precision of the output. Each result is the exact one
+	rounded once, as with IEEE 754:
+
+		ARB_RNDN	to nearest, ties to an even last digit
+		ARB_RNDZ	toward zero
+		ARB_RNDU	toward +infinity
+		ARB_RNDD	toward -infinity
+		ARB_RNDA	away from zero
+
+	Where the exact result has more digits than are worth computing, the
+	operation works out a few guard digits past the precision and knows
+	whether anything nonzero lies past those, which is all that rounding
+	needs. In an odd base one half has no finite expansion, so a result
+	which agrees with it to the last guard digit is rounded down.
+*/
+
+static arb_float *_arb_float_new(arb_float *c, size_t prec, int base)
+{
+	if (prec == 0)
+		arb_error("arb_float: the precision must be at least one digit");
+	if (c == NULL) {
+		c = arb_malloc(sizeof(arb_float));
+		c->x = arb_from_span(NULL, NULL, 0, 0, '+');
+	}
+	c->prec = prec;
+	c->base = base;
+	return c;
+}
+
+/* the output of an operation on 'a' and 'b' */
+static arb_float *_arb_float_out(const arb_float *a, const arb_float *b, arb_float *c)
+{
+	if (c == NULL)
+		c = _arb_float_new(NULL, MAX(a->prec, b ? b->prec : 0), a->base);
+	if (a->base != c->base || (b && b->base != c->base))
+		arb_error("arb_float: the operands are in different bases");
+	return c;
+}
+
+/* whether the integer of the digits d[0] to d[k - 1] is odd */
+static int _arb_float_odd(const UARBT *d, size_t k, int base)
+{
+	size_t i = 0;
+	int odd = 0;
+
+	if (base % 2 == 0)
+		return d[k - 1] % 2;
+	for (; i < k; ++i)
+		odd ^= d[i] % 2;
+	return odd;
+}
+
+/* whether the digits d[k] to d[n - 1], and 'sticky' for any nonzero
+   digits past those, are dropped by rounding up the magnitude. 'half'
+   is only used when the digits held can not tell */
+static int _arb_float_up(const UARBT *d, size_t n, size_t k, int sticky, int half, char sign, int base, int rnd)
+{
+	size_t i = k;
+	int rest = sticky;
+	UARBT h = base / 2;
+
+	for (; i < n && !rest; ++i)
+		rest = d[i] != 0;
+	switch (rnd) {
+	case ARB_RNDZ:
+		return 0;
+	case ARB_RNDA:
+		return rest;
+	case ARB_RNDU:
+		return rest && sign != '-';
+	case ARB_RNDD:
+		return rest && sign == '-';
+	}
+
+	/* to nearest, where d[k] is the first digit past the last one kept */
+	if (k >= n)
+		return 0;
+	if (base % 2) {
+		for (i = k; i < n; ++i)
+			if (d[i] != h)
+				return d[i] > h;
+		if (!sticky)
+			return 0;
+		/* the digits agree with .hhh... as far as they go */
+		if (half)
+			return half > 0;
+		return _arb_float_odd(d, k, base);
+	}
+	if (d[k] != h)
+		return d[k] > h;
+	for (i = k + 1; i < n; ++i)
+		if (d[i])
+			return 1;
+	if (sticky)
+		return 1;
+	return _arb_float_odd(d, k, base);
+}
+
+/* whether rounding r to nearest depends on more than its digits, which
+   happens in an odd base when they agree with one half to the end */
+static int _arb_float_unsure(const arb_float *c, const fxdpnt *r, int sticky, int rnd)
+{
+	size_t z = 0;
+	size_t t = 0;
+	size_t i = 0;
+
+	if (c->base % 2 == 0 || rnd != ARB_RNDN || !sticky)
+		return 0;
+	arb_span(r, &z, &t);
+	if (t - z <= c->prec)
+		return 0;
+	for (i = z + c->prec; i < t; ++i)
+		if (r->number[i] != c->base / 2)
+			return 0;
+	return 1;
+}
+
+/* the point halfway between the magnitude of r cut to 'prec' digits and
+   the next number of 'prec' digits up, times two */
+static fxdpnt *_arb_float_mid(const fxdpnt *r, size_t prec, int base)
+{
+	static const UARBT unit[1] = { 1 };
+	size_t z = 0;
+	size_t t = 0;
+	long pos = arb_span(r, &z, &t);
+	fxdpnt *m = arb_from_span(NULL, r->number + z, prec, pos, '+');
+	fxdpnt *u = arb_from_span(NULL, unit, 1, pos - (long)prec + 1, '+');
+
+	m = arb_mul_ui(m, 2, m, base);
+	m = arb_add(m, u, m, base);
+	arb_free(u);
+	return m;
+}
+
+/* c = r * base^shift, rounded to the precision of 'c'. 'sticky' tells
+   that r is short of the exact result by something which is nonzero but
+   smaller than the last digit of r, and 'half' compares the exact result
+   with _arb_float_mid() when _arb_float_unsure() */
+static arb_float *_arb_float_round(arb_float *c, const fxdpnt *r, long shift, int sticky, int half, int rnd)
+{
+	size_t z = 0;
+	size_t t = 0;
+	long pos = arb_span(r, &z, &t) + shift;
+	const UARBT *d = r->number + z;
+	size_t n = t - z;
+	size_t k = sticky ? c->prec : MIN(n, c->prec);
+	size_t i = 0;
+	char sign = r->sign;
+	UARBT *m = NULL;
+
+	/* a short r is padded with zeros, as the sticky part lies below the
+	   last digit of the precision rather than below the last one of r */
+	c->x = arb_expand(c->x, k ? k : 1);
+	m = c->x->number;
+	memcpy(m, d, MIN(n, k) * sizeof(UARBT));
+	if (k > n)
+		_arb_memset(m + n, 0, k - n);
+	i = k;
+	if (_arb_float_up(d, n, k, sticky, half, sign, c->base, rnd)) {
+		for (; i && m[i - 1] == c->base - 1; --i)
+			m[i - 1] = 0;
+		if (i) {
+			m[i - 1]++;
+		} else {
+			/* 999 went to 1000 */
+			m[0] = 1;
+			k = 1;
+			++pos;
+		}
+	}
+	for (; k && !m[k - 1]; --k)
+		;
+	c->x = arb_from_span(c->x, m, k, pos, sign);
+	return c;
+}
+
+/* a view of the significant digits of 'a' as an integer, without its
+   sign, and the power of the base which that integer is scaled by */
+static const fxdpnt *_arb_float_int(const fxdpnt *a, fxdpnt *v, long *e, size_t *n)
+{
+	size_t z = 0;
+	size_t t = 0;
+	long pos = arb_span(a, &z, &t);
+
+	*n = t - z;
+	*e = pos - (long)*n;
+	if (*n == 0)
+		return zero;
+	v = arb_view(v, a, z, *n, *n);
+	v->sign = '+';
+	return v;
+}
+
+arb_float *arb_float_from(const fxdpnt *a, arb_float *c, size_t prec, int base, int rnd)
+{
+	c = _arb_float_new(c, prec, base);
+	return _arb_float_round(c, a, 0, 0, 0, rnd);
+}
+
+fxdpnt *arb_float_to(const arb_float *a, fxdpnt *c)
+{
+	return arb_copy(c, a->x);
+}
+
+/* 'a', or a single 1 just under base^low in its place when all of 'a'
+   is below base^low, which keeps the rounding of a sum while bounding
+   its length */
+static const fxdpnt *_arb_float_cut(const fxdpnt *a, long low, fxdpnt **tmp)
+{
+	static const UARBT unit[1] = { 1 };
+	size_t z = 0;
+	size_t t = 0;
+
+	if (arb_span(a, &z, &t) > low || z == t)
+		return a;
+	*tmp = arb_from_span(NULL, unit, 1, low, a->sign);
+	return *tmp;
+}
+
+static arb_float *_arb_float_addsub(const arb_float *a, const arb_float *b, arb_float *c, int rnd, int sub)
+{
+	size_t z = 0;
+	size_t t = 0;
+	size_t p = 0;
+	long hx = 0;
+	long hy = 0;
+	long hi = 0;
+	int zx = 0;
+	const fxdpnt *x = a->x;
+	const fxdpnt *y = b->x;
+	fxdpnt *tx = NULL;
+	fxdpnt *ty = NULL;
+	fxdpnt *r = NULL;
+
+	c = _arb_float_out(a, b, c);
+	p = MAX(c->prec, MAX(a->prec, b->prec));
+
+	/* an operand entirely below the guard digits of the other can only
+	   nudge the sum, which rounds the same for any nudge of that size */
+	hx = arb_span(x, &z, &t);
+	zx = z == t;
+	hy = arb_span(y, &z, &t);
+	hi = zx ? hy : z == t ? hx : MAX(hx, hy);
+	x = _arb_float_cut(x, hi - (long)p - 3, &tx);
+	y = _arb_float_cut(y, hi - (long)p - 3, &ty);
+
+	if (sub)
+		r = arb_sub(x, y, NULL, c->base);
+	else
+		r = arb_add(x, y, NULL, c->base);
+	c = _arb_float_round(c, r, 0, 0, 0, rnd);
+	arb_free(tx);
+	arb_free(ty);
+	arb_free(r);
+	return c;
+}
+
+arb_float *arb_float_add(const arb_float *a, const arb_float *b, arb_float *c, int rnd)
+{
+	return _arb_float_addsub(a, b, c, rnd, 0);
+}
+
+arb_float *arb_float_sub(const arb_float *a, const arb_float *b, arb_float *c, int rnd)
+{
+	return _arb_float_addsub(a, b, c, rnd, 1);
+}
+
+arb_float *arb_float_mul(const arb_float *a, const arb_float *b, arb_float *c, int rnd)
+{
+	fxdpnt va[1] = { 0 };
+	fxdpnt vb[1] = { 0 };
+	const fxdpnt *x = NULL;
+	const fxdpnt *y = NULL;
+	fxdpnt *r = NULL;
+	long ea = 0;
+	long eb = 0;
+	size_t na = 0;
+	size_t nb = 0;
+
+	c = _arb_float_out(a, b, c);
+	x = _arb_float_int(a->x, va, &ea, &na);
+	y = _arb_float_int(b->x, vb, &eb, &nb);
+
+	/* the product of the integers is exact */
+	r = arb_mul(x, y, NULL, c->base, 0);
+	r->sign = a->x->sign == b->x->sign ? '+' : '-';
+	c = _arb_float_round(c, r, ea + eb, 0, 0, rnd);
+	arb_free(r);
+	arb_release(va);
+	arb_release(vb);
+	return c;
+}
+
+arb_float *arb_float_div(const arb_float *a, const arb_float *b, arb_float *c, int rnd)
+{
+	fxdpnt va[1] = { 0 };
+	fxdpnt vb[1] = { 0 };
+	const fxdpnt *x = NULL;
+	const fxdpnt *y = NULL;
+	fxdpnt *q = NULL;
+	fxdpnt *r = NULL;
+	fxdpnt *m = NULL;
+	long ea = 0;
+	long eb = 0;
+	size_t na = 0;
+	size_t nb = 0;
+	long s = 0;
+	int sticky = 0;
+	int half = 0;
+
+	x = _arb_float_int(a->x, va, &ea, &na);
+	y = _arb_float_int(b->x, vb, &eb, &nb);
+	if (nb == 0) {
+		fputs("Divide by zero\n", stderr);
+		return NULL;
+	}
+	c = _arb_float_out(a, b, c);
+	if (na == 0)
+		return _arb_float_round(c, zero, 0, 0, 0, rnd);
+
+	/* the quotient of the integers has at least na - nb integer digits,
+	   so 's' fractional digits take it two digits past the precision */
+	s = MAX((long)c->prec + 3 - ((long)na - (long)nb), 0);
+	q = arb_div_nomemo(x, y, NULL, c->base, s);
+
+	/* the truncated digits are nonzero when q * y falls short of x */
+	r = arb_mul(q, y, NULL, c->base, s);
+	sticky = arb_compare(r, x) != 0;
+	if (_arb_float_unsure(c, q, sticky, rnd)) {
+		/* x / y against m / 2 is 2 * x against m * y */
+		m = _arb_float_mid(q, c->prec, c->base);
+		m = arb_mul(m, y, m, c->base, s);
+		r = arb_mul_ui(x, 2, r, c->base);
+		half = arb_compare(r, m);
+		arb_free(m);
+	}
+	q->sign = a->x->sign == b->x->sign ? '+' : '-';
+	c = _arb_float_round(c, q, ea - eb, sticky, half, rnd);
+	arb_free(q);
+	arb_free(r);
+	arb_release(va);
+	arb_release(vb);
+	return c;
+}
+
+/* floor(sqrt(n)) of an integer, with Newton's method from above */
+static fxdpnt *_arb_float_isqrt(const fxdpnt *n, int base)
+{
+	fxdpnt *x = arb_expand(NULL, n->len / 2 + 2);
+	fxdpnt *y = NULL;
+
+	/* base^ceil(len / 2) is more than the root */
+	arb_init(x);
+	x->lp = x->len = (n->len + 1) / 2 + 1;
+	_arb_memset(x->number, 0, x->len);
+	x->number[0] = 1;
+	for (;;) {
+		y = arb_div_nomemo(n, x, y, base, 0);
+		y = arb_add(y, x, y, base);
+		y = arb_divmod_ui(y, 2, y, NULL, base, 0);
+		if (arb_compare(y, x) >= 0)
+			break;
+		x = arb_copy(x, y);
+	}
+	arb_free(y);
+	return x;
+}
+
+arb_float *arb_float_sqrt(const arb_float *a, arb_float *c, int rnd)
+{
+	fxdpnt *n = NULL;
+	fxdpnt *x = NULL;
+	fxdpnt *r = NULL;
+	size_t z = 0;
+	size_t t = 0;
+	long pos = arb_span(a->x, &z, &t);
+	long na = t - z;
+	long e = pos - na;
+	long k = 0;
+	int sticky = 0;
+	int half = 0;
+	fxdpnt *m = NULL;
+
+	if (a->x->sign == '-' && na)
+		return NULL;
+	c = _arb_float_out(a, NULL, c);
+	if (na == 0)
+		return _arb_float_round(c, zero, 0, 0, 0, rnd);
+
+	/* pad the integer with 'k' zeros, so that its root has two digits
+	   past the precision and its exponent is even */
+	k = MAX(2 * (long)c->prec + 4 - na, 0);
+	k += (e - k) & 1;
+	n = arb_expand(NULL, na + k);
+	arb_init(n);
+	n->lp = n->len = na + k;
+	memcpy(n->number, a->x->number + z, na * sizeof(UARBT));
+	_arb_memset(n->number + na, 0, k);
+
+	x = _arb_float_isqrt(n, c->base);
+	r = arb_mul(x, x, NULL, c->base, 0);
+	sticky = arb_compare(r, n) != 0;
+	if (_arb_float_unsure(c, x, sticky, rnd)) {
+		/* sqrt(n) against m / 2 is 4 * n against m * m */
+		m = _arb_float_mid(x, c->prec, c->base);
+		m = arb_mul(m, m, m, c->base, 0);
+		r = arb_mul_ui(n, 4, r, c->base);
+		half = arb_compare(r, m);
+		arb_free(m);
+	}
+	c = _arb_float_round(c, x, (e - k) / 2, sticky, half, rnd);
+	arb_free(n);
+	arb_free(x);
+	arb_free(r);
+	return c;
+}
+
+void arb_float_print(const arb_float *a)
+{
+	arb_print(a->x);
+}
+
+void arb_float_free(arb_float *a)
+{
+	if (!a)
+		return;
+	arb_free(a->x);
+	arb_dealloc(a);
+}
@@ -5,11 +5,13 @@
 
 size_t fxd2sizet(fxdpnt *a, int base)
 {
+	fxdpnt tmp[1] = { 0 };
+	const fxdpnt *f = arb_flat(a, tmp);
 	size_t ret = 0;
 	size_t i = 0;
-	for (; i < a->lp; ++i) {
-		ret = (base * ret) + (a->number[i]);
+	for (; i < f->lp; ++i) {
+		ret = (base * ret) + (f->number[i]);
 	}
+	arb_release(tmp);
 	return ret;
 }
-
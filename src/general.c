@@ -3,7 +3,7 @@
 /* Copyright 2017-2019 CM Graff */
 
 
-void arb_error(char *message)
+void arb_error(const char *message)
 {
 	/* arbitraire exits upon memory exhaustion. This is not ideal, but it
 	   saves many lines of codes versus returning the error back to the
@@ -31,10 +31,31 @@ size_t le(const fxdpnt *a)
 }
 
 /* memory management and bignum creation routines */
+void arb_release(fxdpnt *flt)
+{
+	/* drop a number's claim on its digits. views never own their digits
+	   and shared digits are only freed by their last owner */
+	if (flt->flags & ARB_STATIC)
+		return;
+	if (flt->flags & ARB_VIEW)
+		;
+	else if (flt->refs && --*flt->refs)
+		;
+	else {
+		arb_dealloc(flt->refs);
+		arb_dealloc(flt->number);
+	}
+	flt->refs = NULL;
+	flt->number = NULL;
+}
+
 void arb_free(fxdpnt *flt)
 {
+	/* constants are not ours to free, see ARB_CONST */
+	if (flt && (flt->flags & ARB_STATIC))
+		return;
 	if (flt && flt->number) {
-		free(flt->number);
+		arb_release(flt);
 		/* sanitize the memory */
 		flt->allocated = 0;
 		flt->len = 0;
@@ -42,7 +63,7 @@ void arb_free(fxdpnt *flt)
 		flt->sign = 0;
 	}
 	if (flt)
-		free(flt);
+		arb_dealloc(flt);
 }
 
 void arb_init(fxdpnt *flt)
@@ -50,12 +71,42 @@ void arb_init(fxdpnt *flt)
 	flt->sign = '+';
 	flt->len = 0;
 	flt->lp = 0;
+	flt->exp = 0;
+	flt->flags &= ~ARB_CANON;
+}
+
+/*
+	All of arbitraire's memory goes through arb_malloc, arb_calloc,
+	arb_realloc and arb_dealloc. By default these use the C library, but
+	arb_set_allocator() can route them to any allocator. 'ctx' is passed
+	back to each of the hooks. The allocator has to be set before the
+	first number is made, as memory must be freed by the allocator that
+	made it. Passing NULL hooks restores the C library.
+*/
+
+static void *(*_arb_alloc_hook)(size_t, void *) = NULL;
+static void *(*_arb_realloc_hook)(void *, size_t, void *) = NULL;
+static void (*_arb_dealloc_hook)(void *, void *) = NULL;
+static void *_arb_alloc_ctx = NULL;
+
+void arb_set_allocator(void *(*alloc)(size_t, void *),
+		       void *(*realloc)(void *, size_t, void *),
+		       void (*dealloc)(void *, void *), void *ctx)
+{
+	_arb_alloc_hook = alloc;
+	_arb_realloc_hook = realloc;
+	_arb_dealloc_hook = dealloc;
+	_arb_alloc_ctx = ctx;
 }
 
 void *arb_malloc(size_t len)
 {
 	void *ret;
-	if(!(ret = malloc(len)))
+	if (_arb_alloc_hook)
+		ret = _arb_alloc_hook(len, _arb_alloc_ctx);
+	else
+		ret = malloc(len);
+	if(!ret)
 		arb_error("arb_malloc (malloc) failed\n");
 	return ret;
 }
@@ -63,6 +114,12 @@ void *arb_malloc(size_t len)
 void *arb_calloc(size_t nmemb, size_t len)
 {
 	void *ret;
+	if (_arb_alloc_hook) {
+		if (len && nmemb > SIZE_MAX / len)
+			arb_error("arb_calloc (calloc) failed\n");
+		ret = arb_malloc(nmemb * len);
+		return memset(ret, 0, nmemb * len);
+	}
 	if(!(ret = calloc(nmemb, len)))
 		arb_error("arb_calloc (calloc) failed\n");
 	return ret;
@@ -71,26 +128,27 @@ void *arb_calloc(size_t nmemb, size_t len)
 void *arb_realloc(void *ptr, size_t len)
 {
 	void *ret;
-	if(!(ret = realloc(ptr, len)))
+	if (_arb_realloc_hook)
+		ret = _arb_realloc_hook(ptr, len, _arb_alloc_ctx);
+	else
+		ret = realloc(ptr, len);
+	if(!ret)
 		arb_error("arb_realloc (realloc) failed\n");
 	return ret;
 }
 
-static void arb_cleanup(void)
+void arb_dealloc(void *ptr)
 {
-	/* this function is called by atexit() and should never be
-	   invoked manually */
-	arb_free(zero);
-	arb_free(p5);
-	arb_free(one);
-	arb_free(two);
-	arb_free(three);
-	arb_free(ten);
+	if (_arb_dealloc_hook) {
+		if (ptr)
+			_arb_dealloc_hook(ptr, _arb_alloc_ctx);
+	} else {
+		free(ptr);
+	}
 }
 
 fxdpnt *arb_expand_inter(fxdpnt *o, size_t request, size_t lp, int set)
 {
-	static int lever = 0;
 	size_t original = request;
 	size_t align = 16;
 
@@ -100,13 +158,35 @@ fxdpnt *arb_expand_inter(fxdpnt *o, size_t request, size_t lp, int set)
 	else
 		request = align;
 
+	/* the last owner of formerly shared digits owns them outright */
+	if (o && o->refs && *o->refs == 1) {
+		arb_dealloc(o->refs);
+		o->refs = NULL;
+	}
+
+	/* the number is about to be written to, see remove_leading_zeros() */
+	if (o)
+		o->flags &= ~ARB_CANON;
+
 	/* allocation (vector creation) */
 	if (o == NULL) { 
 		o = arb_malloc(sizeof(fxdpnt));
+		o->flags = 0;
+		o->refs = NULL;
 		arb_init(o);
 		o->number = arb_calloc(1, sizeof(UARBT) * request);
 		o->allocated = request;
 		o->lp = o->len = original;
+	/* views and shared numbers get their own digits before a write */
+	} else if ((o->flags & ARB_VIEW) || (o->refs && *o->refs > 1)) {
+		UARBT *p = o->number;
+		if (o->refs)
+			--*o->refs;
+		o->refs = NULL;
+		o->allocated = MAX(request, o->len);
+		o->number = arb_calloc(1, o->allocated * sizeof(UARBT));
+		_arb_copy_core(o->number, p, o->len);
+		o->flags &= ~ARB_VIEW;
 	/* reallocation (vector expansion) */
 	} else if (request > o->allocated) {
 		o->allocated = request;
@@ -114,18 +194,6 @@ fxdpnt *arb_expand_inter(fxdpnt *o, size_t request, size_t lp, int set)
 		_arb_memset(o->number + o->len, 0, o->allocated - o->len);
 	}
 
-	/* initialize the global constants (once) */
-	if (lever == 0) {
-		lever = 1;
-		zero = arb_str2fxdpnt("0");
-		p5 = arb_str2fxdpnt("0.5");
-		one = arb_str2fxdpnt("1");
-		two = arb_str2fxdpnt("2");
-		three = arb_str2fxdpnt("3");
-		ten = arb_str2fxdpnt("10");
-		atexit(arb_cleanup);
-	}
-
 	/* allow specific radix positioning requests */
 
 	if (set) {
@@ -3,10 +3,20 @@
 /* Copyright 2017-2019 CM Graff */
 
 
-fxdpnt *zero = NULL;
-fxdpnt *p5 = NULL;
-fxdpnt *one = NULL;
-fxdpnt *two = NULL;
-fxdpnt *three = NULL;
-fxdpnt *ten = NULL;
+/* constants are built at compile time and never allocated or freed */
+static const fxdpnt _arb_zero = ARB_CONST("\0", 1, 0);
+static const fxdpnt _arb_p5 = ARB_CONST("\5", 0, 1);
+static const fxdpnt _arb_one = ARB_CONST("\1", 1, 1);
+static const fxdpnt _arb_two = ARB_CONST("\2", 1, 1);
+static const fxdpnt _arb_three = ARB_CONST("\3", 1, 1);
+static const fxdpnt _arb_ten = ARB_CONST("\1\0", 2, 1);
 
+fxdpnt *const zero = (fxdpnt *)&_arb_zero;
+fxdpnt *const p5 = (fxdpnt *)&_arb_p5;
+fxdpnt *const one = (fxdpnt *)&_arb_one;
+fxdpnt *const two = (fxdpnt *)&_arb_two;
+fxdpnt *const three = (fxdpnt *)&_arb_three;
+fxdpnt *const ten = (fxdpnt *)&_arb_ten;
+
+/* arb_copy() shares digits instead of copying them when this is set */
+int _arb_cow = 0;
@@ -0,0 +1,170 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	arb_hash() hashes the value of a number rather than its layout. Leading
+	zeros, trailing fractional zeros and the split between the digits and
+	the exponent are left out, so any two numbers that arb_compare() finds
+	equal hash the same, such as 0.50 and .5, or -0 and 0. The significant
+	digits are hashed 8 at a time in 4 independent lanes, which the
+	compiler can keep in vector registers. The seed picks one of a family
+	of hash functions. It is not a keyed PRF, and collisions which hold for
+	every seed can be built, so tables keyed on untrusted numbers should
+	not rely on it to stop flooding.
+
+	An intern table keeps one copy of each distinct value it is given.
+	arb_intern() returns that copy, so interned numbers which are equal are
+	the same pointer. The copy is kept in canonical form, without trailing
+	fractional zeros, and is owned by the table. It must not be written to,
+	and arb_free() leaves it alone. The table is not thread safe.
+*/
+
+#define ARB_P1 0x9E3779B185EBCA87ULL
+#define ARB_P2 0xC2B2AE3D27D4EB4FULL
+#define ARB_P3 0x165667B19E3779F9ULL
+#define ARB_P4 0x85EBCA77C2B2AE63ULL
+
+static uint64_t _arb_rotl(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t _arb_round(uint64_t h, uint64_t w)
+{
+	return _arb_rotl(h + w * ARB_P2, 31) * ARB_P1;
+}
+
+static uint64_t _arb_word8(const UARBT *p)
+{
+	uint64_t w = 0;
+	memcpy(&w, p, sizeof(w));
+	return w;
+}
+
+static uint64_t _arb_avalanche(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= ARB_P2;
+	h ^= h >> 29;
+	h *= ARB_P3;
+	h ^= h >> 32;
+	return h;
+}
+
+uint64_t arb_hash(const fxdpnt *a, uint64_t seed)
+{
+	size_t z = 0;
+	size_t t = 0;
+	long pos = arb_span(a, &z, &t);
+	const UARBT *p = a->number + z;
+	size_t n = t - z;
+	size_t i = 0;
+	uint64_t h = 0;
+	uint64_t l[4] = { seed + ARB_P1 + ARB_P2, seed + ARB_P2, seed, seed - ARB_P1 };
+	UARBT tail[8] = { 0 };
+
+	if (n == 0)
+		return _arb_avalanche(seed ^ ARB_P4);
+
+	for (; i + 32 <= n; i += 32) {
+		l[0] = _arb_round(l[0], _arb_word8(p + i));
+		l[1] = _arb_round(l[1], _arb_word8(p + i + 8));
+		l[2] = _arb_round(l[2], _arb_word8(p + i + 16));
+		l[3] = _arb_round(l[3], _arb_word8(p + i + 24));
+	}
+	h = _arb_rotl(l[0], 1) + _arb_rotl(l[1], 7) + _arb_rotl(l[2], 12) + _arb_rotl(l[3], 18);
+	for (; i + 8 <= n; i += 8)
+		h = _arb_round(h, _arb_word8(p + i));
+	if (i < n) {
+		memcpy(tail, p + i, (n - i) * sizeof(UARBT));
+		h = _arb_round(h, _arb_word8(tail));
+	}
+
+	/* the digits alone do not tell 12 from 1.2 or -12 */
+	h ^= _arb_round(0, (uint64_t)pos);
+	h ^= _arb_round(n, a->sign == '-');
+	return _arb_avalanche(h);
+}
+
+static void _arb_intern_grow(arb_intern_table *t)
+{
+	size_t cap = t->cap ? t->cap * 2 : 64;
+	fxdpnt **slot = arb_calloc(cap, sizeof(fxdpnt *));
+	uint64_t *hash = arb_malloc(cap * sizeof(uint64_t));
+	size_t i = 0;
+	size_t j = 0;
+
+	for (; i < t->cap; ++i) {
+		if (!t->slot[i])
+			continue;
+		for (j = t->hash[i] & (cap - 1); slot[j]; j = (j + 1) & (cap - 1))
+			;
+		slot[j] = t->slot[i];
+		hash[j] = t->hash[i];
+	}
+	arb_dealloc(t->slot);
+	arb_dealloc(t->hash);
+	t->slot = slot;
+	t->hash = hash;
+	t->cap = cap;
+}
+
+arb_intern_table *arb_intern_new(uint64_t seed)
+{
+	arb_intern_table *t = arb_malloc(sizeof(arb_intern_table));
+	t->slot = NULL;
+	t->hash = NULL;
+	t->n = t->cap = 0;
+	t->seed = seed;
+	_arb_intern_grow(t);
+	return t;
+}
+
+const fxdpnt *arb_intern(arb_intern_table *t, const fxdpnt *a)
+{
+	uint64_t h = arb_hash(a, t->seed);
+	size_t i = h & (t->cap - 1);
+	size_t z = 0;
+	size_t end = 0;
+	long pos = 0;
+
+	for (; t->slot[i]; i = (i + 1) & (t->cap - 1))
+		if (t->hash[i] == h && arb_compare(t->slot[i], a) == 0)
+			return t->slot[i];
+
+	/* keep the table at most three quarters full */
+	if ((t->n + 1) * 4 > t->cap * 3) {
+		_arb_intern_grow(t);
+		for (i = h & (t->cap - 1); t->slot[i]; i = (i + 1) & (t->cap - 1))
+			;
+	}
+	pos = arb_span(a, &z, &end);
+	t->slot[i] = arb_from_span(NULL, a->number + z, end - z, pos, a->sign);
+	t->slot[i]->flags |= ARB_STATIC;
+	t->hash[i] = h;
+	t->n++;
+	return t->slot[i];
+}
+
+size_t arb_intern_count(const arb_intern_table *t)
+{
+	return t->n;
+}
+
+void arb_intern_free(arb_intern_table *t)
+{
+	size_t i = 0;
+
+	if (!t)
+		return;
+	for (; i < t->cap; ++i) {
+		if (t->slot[i]) {
+			t->slot[i]->flags &= ~ARB_STATIC;
+			arb_free(t->slot[i]);
+		}
+	}
+	arb_dealloc(t->slot);
+	arb_dealloc(t->hash);
+	arb_dealloc(t);
+}
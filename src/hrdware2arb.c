@@ -2,11 +2,361 @@
 
 /* Copyright 2017-2019 CM Graff */
 
+/*
+	Conversions between numbers and hardware types. None of these go
+	through a string of characters, and the conversions to numbers write
+	into 'c', which may be NULL, like any other operation.
+
+	arb_from_double() is exact. Every double is an integer times a power
+	of two, and 2^-k has exactly k digits in an even base, so nothing is
+	lost. In an odd base 2^-k does not end, and it is truncated to k + 64
+	digits, which is well past the precision of the double.
+
+	arb_to_double() reads only the leading digits of a number. Any digits
+	past those only matter to the rounding, so they are folded into a
+	single sticky digit. In bases which are a power of two a word's worth
+	of digits is enough for that. In base 10 a number which fits in a
+	word and a power of ten that a double holds exactly is converted with
+	one multiplication or division. Otherwise the word is scaled in a long
+	double, whose extra bits show whether the result is near a halfway
+	point between two doubles. Only then is the number compared with the
+	halfway points themselves, which are exact in base 10. Both of those
+	are correctly rounded to nearest. In other bases the result is the
+	closest the long double type can get.
+
+	arb_to_i64() truncates the fraction like fxd2sizet(), but returns -1
+	and leaves '*r' alone when the integer part does not fit.
+*/
+
 fxdpnt *hrdware2arb(size_t a)
 {
-	char str[50];
-	sprintf(str, "%zu", a);
-	fxdpnt *ret = arb_str2fxdpnt(str);
-	return ret;
+	return arb_from_u64(a, NULL, 10);
+}
+
+/* write the magnitude 'w' into 'c' */
+static fxdpnt *_arb_from_wide(arb_dlimb w, char sign, fxdpnt *c, int base)
+{
+	size_t n = 1;
+	arb_dlimb t = w;
+
+	for (; t >= (arb_dlimb)base; t /= base)
+		++n;
+	c = arb_expand(c, n);
+	arb_init(c);
+	c->lp = c->len = n;
+	while (n) {
+		c->number[--n] = w % base;
+		w /= base;
+	}
+	c->sign = sign;
+	c = remove_leading_zeros(c);
+	if (c->sig == 0)
+		c->sign = '+';
+	return c;
+}
+
+fxdpnt *arb_from_u64(uint64_t a, fxdpnt *c, int base)
+{
+	return _arb_from_wide(a, '+', c, base);
+}
+
+fxdpnt *arb_from_i64(int64_t a, fxdpnt *c, int base)
+{
+	/* negate in unsigned arithmetic so that INT64_MIN survives */
+	if (a < 0)
+		return _arb_from_wide(-(uint64_t)a, '-', c, base);
+	return _arb_from_wide(a, '+', c, base);
+}
+
+#ifdef __SIZEOF_INT128__
+fxdpnt *arb_from_i128(__int128 a, fxdpnt *c, int base)
+{
+	if (a < 0)
+		return _arb_from_wide(-(unsigned __int128)a, '-', c, base);
+	return _arb_from_wide(a, '+', c, base);
+}
+#endif
+
+/* c *= w^k, a word sized chunk of the power at a time */
+static fxdpnt *_arb_mul_pow(fxdpnt *c, size_t w, size_t k, int base)
+{
+	size_t lim = SIZE_MAX / base;
+	size_t p = 1;
+
+	while (k) {
+		for (p = 1; k && p <= lim / w; --k)
+			p *= w;
+		c = arb_mul_ui(c, p, c, base);
+	}
+	return c;
+}
+
+/* the number m * 2^e */
+static fxdpnt *_arb_from_bin(uint64_t m, long e, char sign, fxdpnt *c, int base)
+{
+	size_t k = 0;
+
+	for (; m && !(m & 1); m >>= 1)
+		++e;
+	c = arb_from_u64(m, c, base);
+
+	if (e >= 0) {
+		c = _arb_mul_pow(c, 2, e, base);
+	} else if (base % 2 == 0) {
+		/* m / 2^k = m * (base / 2)^k / base^k */
+		k = -(long)e;
+		c = _arb_mul_pow(c, base / 2, k, base);
+		c = arb_shift_radix(c, -(long)k);
+	} else {
+		fxdpnt *p = arb_copy(NULL, one);
+		fxdpnt *q = NULL;
+		k = -(long)e;
+		p = _arb_mul_pow(p, 2, k, base);
+		q = arb_div_nomemo(c, p, NULL, base, k + 64);
+		arb_free(p);
+		arb_free(c);
+		c = q;
+	}
+	c->sign = sign;
+	c = remove_leading_zeros(c);
+	if (c->sig == 0)
+		c->sign = '+';
+	return c;
+}
+
+/* the integer 'm' and exponent 'e' of 53 bits or fewer with d = m * 2^e */
+static uint64_t _arb_dbl_bits(double d, long *e)
+{
+	int x = 0;
+	uint64_t m = (uint64_t)ldexp(fabs(frexp(d, &x)), 53);
+
+	*e = (long)x - 53;
+	return m;
 }
 
+fxdpnt *arb_from_double(double d, fxdpnt *c, int base)
+{
+	long e = 0;
+	uint64_t m = 0;
+
+	if (d != d || d - d != 0) {
+		fputs("arb_from_double: not a finite number\n", stderr);
+		return NULL;
+	}
+	if (d == 0)
+		return arb_from_u64(0, c, base);
+
+	/* d = m * 2^e */
+	m = _arb_dbl_bits(d, &e);
+	return _arb_from_bin(m, e, d < 0 ? '-' : '+', c, base);
+}
+
+/* digit 'i' of the integer part of 'a', which may lie in its exponent */
+static UARBT _arb_int_digit(const fxdpnt *a, size_t i)
+{
+	return i < a->len ? a->number[i] : 0;
+}
+
+int arb_to_i64(const fxdpnt *a, int64_t *r, int base)
+{
+	long ilen = (long)a->lp + a->exp;
+	uint64_t lim = a->sign == '-' ? (uint64_t)INT64_MAX + 1 : INT64_MAX;
+	uint64_t u = 0;
+	UARBT d = 0;
+	long i = 0;
+
+	/* past the stored digits there are only zeros */
+	for (; i < ilen && (u || (size_t)i < a->len); ++i) {
+		d = _arb_int_digit(a, i);
+		if (u > (lim - d) / base)
+			return -1;
+		u = u * base + d;
+	}
+	if (r)
+		*r = a->sign == '-' ? (int64_t)(0 - u) : (int64_t)u;
+	return 0;
+}
+
+/* exact powers of ten, as far as a double holds them */
+static const double _arb_p10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* whether the last stored bit of the significand of 'd' is set. For a
+   subnormal that is not the last bit of the mantissa from frexp() */
+static int _arb_dbl_odd(double d)
+{
+	uint64_t u = 0;
+
+	memcpy(&u, &d, sizeof(u));
+	return u & 1;
+}
+
+/* |a| compared with the halfway point of mx * 2^ex and my * 2^ey */
+static int _arb_cmp_half(const fxdpnt *a, uint64_t mx, long ex, uint64_t my, long ey)
+{
+	fxdpnt v[1] = { 0 };
+	fxdpnt *h = NULL;
+	long e = 0;
+	int r = 0;
+
+	/* neighbouring doubles are at most a binade apart, so their sum on
+	   the smaller exponent fits a word */
+	if (mx == 0)
+		ex = ey;
+	e = MIN(ex, ey);
+	h = _arb_from_bin((mx << (ex - e)) + (my << (ey - e)), e - 1, '+', NULL, 10);
+	arb_view(v, a, 0, a->len, a->lp);
+	v->exp = a->exp;
+	v->sign = '+';
+	r = arb_compare(v, h);
+	arb_free(h);
+	return r;
+}
+
+/* |a| = m * 10^e, where 'sticky' says m lost nonzero digits below it */
+static double _arb_to_double10(const fxdpnt *a, uint64_t m, int sticky, long e)
+{
+	long double x = m;
+	long double p = 1;
+	long double b = 10;
+	unsigned long ue = 0;
+	long chunk = 0;
+	uint64_t bits = 0;
+	unsigned low = 0;
+	int ex = 0;
+	double d = 0;
+	double y = 0;
+	uint64_t md = 0;
+	uint64_t my = 0;
+	long ed = 0;
+	long ey = 0;
+	int r = 0;
+
+	/* 'm' has at most 20 digits, so these are out of range either way */
+	if (e > 310)
+		return HUGE_VAL;
+	if (e < -345)
+		return 0;
+
+	/* an estimate in the wider long double, scaled in chunks so that the
+	   powers of ten do not overflow where long double is a double */
+	for (; e; e -= chunk) {
+		chunk = MAX(MIN(e, 256L), -256L);
+		ue = chunk < 0 ? -chunk : chunk;
+		for (p = 1, b = 10; ue; ue >>= 1, b *= b)
+			if (ue & 1)
+				p *= b;
+		x = chunk < 0 ? x / p : x * p;
+	}
+	d = (double)x;
+
+	/* when the 11 bits of the estimate below those of a normal double are
+	   far from a halfway point, the few units of error in the estimate and
+	   the digits lost from 'm' can not cross one */
+	if (LDBL_MANT_DIG >= 64 && d >= DBL_MIN && d <= DBL_MAX) {
+		bits = (uint64_t)ldexpl(frexpl(x, &ex), 64);
+		low = bits & 2047;
+		if ((low < 1024 - 64 || low > 1024 + 64) && (low > 64 || !sticky))
+			return d;
+	}
+
+	/* otherwise step over each halfway point that the number lies beyond,
+	   comparing with the number itself, and break ties to even */
+	if (d > DBL_MAX)
+		d = DBL_MAX;
+	for (;;) {
+		md = _arb_dbl_bits(d, &ed);
+		if (d == DBL_MAX) {
+			/* the next step is 2^1024, where the result overflows */
+			my = 1;
+			ey = 1024;
+		} else {
+			y = nextafter(d, HUGE_VAL);
+			my = _arb_dbl_bits(y, &ey);
+		}
+		r = _arb_cmp_half(a, md, ed, my, ey);
+		if (r > 0 || (r == 0 && _arb_dbl_odd(d))) {
+			if (d == DBL_MAX)
+				return HUGE_VAL;
+			d = y;
+			continue;
+		}
+		if (d == 0)
+			return d;
+		y = nextafter(d, 0);
+		my = _arb_dbl_bits(y, &ey);
+		r = _arb_cmp_half(a, my, ey, md, ed);
+		if (r < 0 || (r == 0 && _arb_dbl_odd(d))) {
+			d = y;
+			continue;
+		}
+		return d;
+	}
+}
+
+double arb_to_double(const fxdpnt *a, int base)
+{
+	const UARBT *dig = NULL;
+	size_t z = 0;
+	size_t n = 0;
+	size_t i = 0;
+	size_t end = a->flags & ARB_CANON ? a->sig : a->len;
+	size_t k = arb_pow2base(base);
+	int sticky = 0;
+	uint64_t m = 0;
+	long e = 0;
+	double ret = 0;
+
+	/* skip to the leading digit, and read as many as fit in a word */
+	for (; z < end && !a->number[z]; ++z)
+		;
+	if (z == end)
+		return 0;
+	dig = a->number + z;
+	for (; z + n < end && m <= (UINT64_MAX - (base - 1)) / base; ++n)
+		m = m * base + dig[n];
+	for (i = z + n; i < end && !sticky; ++i)
+		sticky = a->number[i] != 0;
+
+	/* the value is m * base^e, give or take the sticky digit */
+	e = (long)a->lp + a->exp - (long)(z + n);
+
+	if (base == 10) {
+		if (!sticky && m <= (1ULL << 53) && e >= -22 && e <= 22)
+			ret = e < 0 ? m / _arb_p10[-e] : m * _arb_p10[e];
+		else
+			ret = _arb_to_double10(a, m, sticky, e);
+	} else if (k) {
+		/* line the bits up at the top of the word, so that the sticky
+		   bit lies below those which a double can round to */
+		int sh = 0;
+		for (; !(m >> 63); ++sh)
+			m <<= 1;
+		e = e * (long)k - sh;
+		e = MAX(MIN(e, 1L << 20), -(1L << 20));
+		if (e >= -1074 - 11) {
+			ret = ldexp((double)(m | sticky), (int)e);
+		} else {
+			/* a subnormal has fewer bits than the conversion of 'm'
+			   would round to, so round once to the multiple of
+			   2^-1074 here, which then converts exactly */
+			unsigned s = -1074 - e;
+			uint64_t q = s < 64 ? m >> s : 0;
+			uint64_t r = s < 64 ? m << (64 - s) : s == 64 ? m : 0;
+			if (r > (1ULL << 63) || (r == (1ULL << 63) && (sticky || (q & 1))))
+				++q;
+			ret = ldexp((double)q, -1074);
+		}
+	} else {
+		long double p = 1;
+		long double b = base;
+		unsigned long ue = e < 0 ? 0 - (unsigned long)e : (unsigned long)e;
+		for (; ue; ue >>= 1, b *= b)
+			if (ue & 1)
+				p *= b;
+		ret = e < 0 ? m / p : m * p;
+	}
+	return a->sign == '-' ? -ret : ret;
+}
@@ -9,6 +9,7 @@
 #define _ARB_TIME 0
 #endif
 
+#include <float.h>
 #include <limits.h>
 #include <math.h>
 #include <stdarg.h>
@@ -26,6 +27,9 @@
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) > (b) ? (b) : (a))
 
+/* zero runs at least this long are parsed into the exponent */
+#define ARB_ZERO_RUN 32
+
 /* structures */
 typedef struct {	/* fxdpnt fixed point type */
 	UARBT *number;	/* The actual number */
@@ -33,16 +37,74 @@ typedef struct {	/* fxdpnt fixed point type */
 	size_t lp;	/* Length left of radix */
 	size_t len;	/* Length of number (count of digits / limbs) */
 	size_t allocated;/* Length of allocated memory */
+	int flags;	/* Ownership of the number (see below) */
+	size_t *refs;	/* Reference count of a shared number, or NULL */
+	size_t sig;	/* Length without trailing zeros (with ARB_CANON) */
+	long exp;	/* Power of the base the number is scaled by */
 } fxdpnt;
 
+/* limbs of the binary engine (see src/bin.c) */
+#ifdef __SIZEOF_INT128__
+typedef uint64_t arb_limb;
+typedef unsigned __int128 arb_dlimb;
+#else
+typedef uint32_t arb_limb;
+typedef uint64_t arb_dlimb;
+#endif
+#define ARB_LIMB_BITS (sizeof(arb_limb) * CHAR_BIT)
+
+typedef struct {	/* arb_bin binary integer type */
+	arb_limb *limb;	/* Limbs, least significant first */
+	size_t n;	/* Count of limbs in use */
+	size_t allocated;/* Count of limbs allocated */
+	char sign;	/* Sign */
+	fxdpnt *dec;	/* Cached digit form, or NULL */
+	int dec_base;	/* Base of the cached digit form */
+} arb_bin;
+
+typedef struct {	/* arb_intern_table of unique numbers */
+	fxdpnt **slot;	/* Open addressed slots, NULL when empty */
+	uint64_t *hash;	/* Hash of the number in each slot */
+	size_t n;	/* Count of numbers held */
+	size_t cap;	/* Count of slots, a power of two */
+	uint64_t seed;	/* Seed of arb_hash */
+} arb_intern_table;
+
+typedef struct {	/* arb_float floating point type */
+	fxdpnt *x;	/* Value, with at most 'prec' significant digits */
+	size_t prec;	/* Count of significant digits */
+	int base;	/* Base of the digits */
+} arb_float;
+
+/* arb_float rounding modes */
+#define ARB_RNDN 0	/* to nearest, ties to even */
+#define ARB_RNDZ 1	/* toward zero */
+#define ARB_RNDU 2	/* toward +infinity */
+#define ARB_RNDD 3	/* toward -infinity */
+#define ARB_RNDA 4	/* away from zero */
+
+/* fxdpnt flags */
+#define ARB_VIEW 1	/* number aliases the digits of another fxdpnt */
+#define ARB_CANON 2	/* no leading zeros and 'sig' is valid */
+#define ARB_STATIC 4	/* number is a constant or interned, never freed */
+
+/* a canonical constant with the digits 'd' (a string of digit values, not
+   of characters), 'l' of them left of the radix and 's' significant, such
+   as ARB_CONST("\5", 0, 1) for .5. constants are views of read-only
+   memory, so they can be read by any operation but never written to or
+   freed */
+#define ARB_CONST(d, l, s) { .number = (UARBT *)(d), .sign = '+', .lp = (l), \
+	.len = sizeof(d) - 1, .flags = ARB_VIEW | ARB_STATIC | ARB_CANON, .sig = (s) }
+
 /* globals */
-extern fxdpnt *zero;
-extern fxdpnt *p5;
-extern fxdpnt *one;
-extern fxdpnt *two;
-extern fxdpnt *three;
-extern fxdpnt *ten;
+extern fxdpnt *const zero;
+extern fxdpnt *const p5;
+extern fxdpnt *const one;
+extern fxdpnt *const two;
+extern fxdpnt *const three;
+extern fxdpnt *const ten;
 extern long _arb_time;
+extern int _arb_cow;
 
 /* function prototypes */
 /* arithmetic */
@@ -51,6 +113,7 @@ fxdpnt *arb_mul(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
 fxdpnt *arb_mul2(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
 fxdpnt *arb_comba(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
 size_t arb_mul_core(const UARBT *, size_t, const UARBT *, size_t, UARBT *, int);
+fxdpnt *arb_addmul(const fxdpnt *, const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
 fxdpnt *arb_karatsuba_mul(const fxdpnt *, const fxdpnt *, fxdpnt *, int,
 						  size_t);
 fxdpnt *arb_add_inter(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
@@ -61,11 +124,51 @@ fxdpnt *arb_sub2(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
 fxdpnt *arb_add2(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
 fxdpnt *arb_newtonian_div(fxdpnt *, fxdpnt *, fxdpnt *, int, int, fxdpnt *);
 fxdpnt *arb_div(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
+void arb_div_space_free(void);
+fxdpnt *arb_divexact(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
+/* word operations */
+fxdpnt *arb_add_ui(const fxdpnt *, size_t, fxdpnt *, int);
+fxdpnt *arb_sub_ui(const fxdpnt *, size_t, fxdpnt *, int);
+fxdpnt *arb_mul_ui(const fxdpnt *, size_t, fxdpnt *, int);
+fxdpnt *arb_divmod_ui(const fxdpnt *, size_t, fxdpnt *, size_t *, int, size_t);
+int arb_cmp_ui(const fxdpnt *, size_t, int);
+size_t arb_mod_ui(const fxdpnt *, size_t, int);
+int arb_divisible_ui(const fxdpnt *, size_t, int);
+/* binary engine */
+arb_bin *arb_bin_from(const fxdpnt *, arb_bin *, int);
+fxdpnt *arb_bin_to(const arb_bin *, fxdpnt *, int);
+arb_bin *arb_bin_add(const arb_bin *, const arb_bin *, arb_bin *);
+arb_bin *arb_bin_sub(const arb_bin *, const arb_bin *, arb_bin *);
+arb_bin *arb_bin_mul(const arb_bin *, const arb_bin *, arb_bin *);
+int arb_bin_cmp(const arb_bin *, const arb_bin *);
+void arb_bin_print(const arb_bin *, int);
+void arb_bin_free(arb_bin *);
+/* floating point */
+arb_float *arb_float_from(const fxdpnt *, arb_float *, size_t, int, int);
+fxdpnt *arb_float_to(const arb_float *, fxdpnt *);
+arb_float *arb_float_add(const arb_float *, const arb_float *, arb_float *, int);
+arb_float *arb_float_sub(const arb_float *, const arb_float *, arb_float *, int);
+arb_float *arb_float_mul(const arb_float *, const arb_float *, arb_float *, int);
+arb_float *arb_float_div(const arb_float *, const arb_float *, arb_float *, int);
+arb_float *arb_float_sqrt(const arb_float *, arb_float *, int);
+void arb_float_print(const arb_float *);
+void arb_float_free(arb_float *);
 /* modulus */
 fxdpnt *arb_mod(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
 /* logical shift */
 fxdpnt *arb_leftshift(fxdpnt *, size_t);
 fxdpnt *arb_rightshift(fxdpnt *, size_t);
+/* bitwise */
+int arb_pow2base(int);
+fxdpnt *arb_and(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
+fxdpnt *arb_or(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
+fxdpnt *arb_xor(const fxdpnt *, const fxdpnt *, fxdpnt *, int);
+fxdpnt *arb_shl_bits(const fxdpnt *, size_t, fxdpnt *, int);
+fxdpnt *arb_shr_bits(const fxdpnt *, size_t, fxdpnt *, int);
+/* radix shift */
+fxdpnt *arb_shift_radix(fxdpnt *, long);
+fxdpnt *arb_mul_basepow(const fxdpnt *, long, fxdpnt *);
+fxdpnt *arb_div_basepow(const fxdpnt *, long, fxdpnt *);
 /* general */
 void arb_flipsign(fxdpnt *);
 void arb_setsign(const fxdpnt *, const fxdpnt *, fxdpnt *);
@@ -78,25 +181,86 @@ fxdpnt *arb_parse_str(fxdpnt *, const char *);
 int arb_highbase(int);
 /* comparison */
 int arb_compare(const fxdpnt *, const fxdpnt *);
+int arb_cmp_mul(const fxdpnt *, const fxdpnt *, const fxdpnt *, int);
+int arb_cmp_sqr(const fxdpnt *, const fxdpnt *, int);
+int arb_equal(const fxdpnt *, const fxdpnt *);
 /* copying */
 void _arb_copy_core(UARBT *, UARBT *, size_t);
+fxdpnt *_arb_copy_digits(fxdpnt *, const fxdpnt *);
 fxdpnt *arb_copy(fxdpnt *, const fxdpnt *);
+fxdpnt *arb_share(fxdpnt *, const fxdpnt *);
+int arb_set_cow(int);
 /* sqrt */
 fxdpnt *nsqrt(fxdpnt *, int, size_t);
 fxdpnt *long_sqrt(fxdpnt *, int, size_t);
 /* general */
 void arb_init(fxdpnt *);
-void arb_error(char *);
+void arb_error(const char *);
 /* allocation */
 fxdpnt *arb_expand(fxdpnt *, size_t);
 fxdpnt *arb_expand_inter(fxdpnt *, size_t, size_t, int);
 void *arb_malloc(size_t);
 void *arb_realloc(void *, size_t);
 void *arb_calloc(size_t, size_t);
+void arb_dealloc(void *);
+void arb_set_allocator(void *(*)(size_t, void *), void *(*)(void *, size_t, void *),
+		       void (*)(void *, void *), void *);
 void arb_free(fxdpnt *);
+void arb_release(fxdpnt *);
 /* to hardware and back */
 fxdpnt *hrdware2arb(size_t);
 size_t fxd2sizet(fxdpnt *, int);
+fxdpnt *arb_from_u64(uint64_t, fxdpnt *, int);
+fxdpnt *arb_from_i64(int64_t, fxdpnt *, int);
+#ifdef __SIZEOF_INT128__
+fxdpnt *arb_from_i128(__int128, fxdpnt *, int);
+#endif
+fxdpnt *arb_from_double(double, fxdpnt *, int);
+int arb_to_i64(const fxdpnt *, int64_t *, int);
+double arb_to_double(const fxdpnt *, int);
+/* memo cache */
+#define ARB_MEMO_DIV 1
+#define ARB_MEMO_MOD 2
+#define ARB_MEMO_NSQRT 3
+#define ARB_MEMO_LHSQRT 4
+extern size_t _arb_memo_budget;
+fxdpnt *arb_memo_get(int, const fxdpnt *, const fxdpnt *, int, size_t, fxdpnt *);
+void arb_memo_put(int, const fxdpnt *, const fxdpnt *, int, size_t, const fxdpnt *);
+void arb_memo_enable(size_t);
+void arb_memo_clear(void);
+void arb_memo_stats(size_t *, size_t *, size_t *);
+fxdpnt *arb_div_nomemo(const fxdpnt *, const fxdpnt *, fxdpnt *, int, size_t);
+/* sort keys */
+size_t arb_sortkey_encode(const fxdpnt *, unsigned char *, size_t, int);
+size_t arb_sortkey_prefix(const fxdpnt *, unsigned char *, size_t, int);
+fxdpnt *arb_sortkey_decode(const unsigned char *, size_t, fxdpnt *);
+/* sorting */
+void arb_sort(fxdpnt **, size_t, int);
+void arb_topk(fxdpnt **, size_t, size_t, int);
+/* hashing and interning */
+uint64_t arb_hash(const fxdpnt *, uint64_t);
+arb_intern_table *arb_intern_new(uint64_t);
+const fxdpnt *arb_intern(arb_intern_table *, const fxdpnt *);
+size_t arb_intern_count(const arb_intern_table *);
+void arb_intern_free(arb_intern_table *);
+/* digit import and export */
+int arb_export_digits(const fxdpnt *, unsigned char *, size_t, size_t, char *);
+fxdpnt *arb_import_digits(fxdpnt *, const unsigned char *, size_t, size_t, char);
+/* views */
+fxdpnt *arb_view(fxdpnt *, const fxdpnt *, size_t, size_t, size_t);
+fxdpnt *arb_view_int(fxdpnt *, const fxdpnt *);
+fxdpnt *arb_view_frac(fxdpnt *, const fxdpnt *);
+int arb_aliases(const fxdpnt *, const fxdpnt *);
+/* exponents */
+fxdpnt *arb_flatten(fxdpnt *);
+const fxdpnt *arb_flat(const fxdpnt *, fxdpnt *);
+long arb_span(const fxdpnt *, size_t *, size_t *);
+fxdpnt *arb_from_span(fxdpnt *, const UARBT *, size_t, long, char);
+const fxdpnt *arb_align(const fxdpnt *, long, fxdpnt *);
+fxdpnt *arb_compress(fxdpnt *);
+size_t arb_rr(const fxdpnt *);
+fxdpnt *arb_cut(fxdpnt *, size_t);
+fxdpnt *arb_mul_exp(fxdpnt *, const fxdpnt *, const fxdpnt *, size_t);
 /* general */
 fxdpnt *remove_leading_zeros(fxdpnt *);
 size_t rr(const fxdpnt *);
@@ -130,8 +294,9 @@ int oddity(size_t);
 /* memset */
 void *_arb_memset(void *, int, size_t);
 /* zeros */
-size_t count_leading_fractional_zeros(fxdpnt *);
+size_t count_leading_fractional_zeros(const fxdpnt *);
 size_t count_leading_zeros(const fxdpnt *);
+size_t arb_trailing_zeros(const UARBT *, size_t);
 /* some macros to make debugging and timing less intrusive */
 #define _arb_time_start \
 	if (_ARB_TIME) _arb_time = clock()
@@ -6,6 +6,11 @@
 int iszero(const fxdpnt *a)
 {
 	size_t i = 0;
+
+	/* canonical numbers know their length without trailing zeros */
+	if (a->flags & ARB_CANON)
+		return a->sig != 0;
+
 	for (i=0; i < a->len; ++i) {
 		if (a->number[i] != 0)
 			return 1;
@@ -23,19 +23,15 @@ static fxdpnt *karatsuba(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 	z1 = z2 = z3 = z4 = z6 = z7 = z8 = NULL;
 	fxdpnt *z5 = arb_expand(NULL, 0);
 
-	/* stack variables as/with pointers to valid fxdpnts */
+	/* stack views of the upper and lower halves of the operands */
 	fxdpnt x1[1] = { 0 };
-	x1->number = a->number;
-	x1->lp = x1->len = a->len - m;
 	fxdpnt y1[1] = { 0 };
-	y1->number = b->number;
-	y1->lp = y1->len = b->len - m;
 	fxdpnt x0[1] = { 0 };
-	x0->number = a->number + a->len - m;
-	x0->lp = x0->len = m;
 	fxdpnt y0[1] = { 0 };
-	y0->number = b->number + b->len - m;
-	y0->lp = y0->len = m;
+	arb_view(x1, a, 0, a->len - m, a->len - m);
+	arb_view(y1, b, 0, b->len - m, b->len - m);
+	arb_view(x0, a, a->len - m, m, m);
+	arb_view(y0, b, b->len - m, m, m);
 
 	/* the recursions, adds and subs (the actual function) */
 	z1 = karatsuba(x1, y1, z1, base);
@@ -47,8 +43,9 @@ static fxdpnt *karatsuba(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 
 	z6 = arb_sub2(z5, z1, z6, base);
 	z7 = arb_sub2(z6, z4, z7, base);
-	z7 = arb_expand_inter(z7, z7->len + m, z7->len + m, 1);
-	z1 = arb_expand_inter(z1, z1->len + 2 * m, z1->len + 2 * m, 1);
+	/* scale z7 and z1 by base^m and base^2m without padding their digits */
+	z7 = arb_shift_radix(z7, m);
+	z1 = arb_shift_radix(z1, 2 * m);
 	z8 = arb_add2(z1, z7, z8, base);
 	c = arb_add2(z8, z4, c, base);
 
@@ -64,14 +61,51 @@ static fxdpnt *karatsuba(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base)
 	return c;
 }
 
-fxdpnt *arb_karatsuba_mul(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, size_t scale)
+fxdpnt *arb_karatsuba_mul(const fxdpnt *ea, const fxdpnt *eb, fxdpnt *c, int base, size_t scale)
 {
-	fxdpnt *c2 = arb_expand(NULL, a->len + b->len + 3);
-	c2 = karatsuba(a, b, c2, base);
+	/* the stored digits are multiplied, and the product is given the
+	   exponents of the operands at the end */
+	fxdpnt fa[1] = { 0 };
+	fxdpnt fb[1] = { 0 };
+	const fxdpnt *a = arb_view(fa, ea, 0, ea->len, ea->lp);
+	const fxdpnt *b = arb_view(fb, eb, 0, eb->len, eb->lp);
+
+	/* the recursion only sees the operands without their trailing zeros */
+	size_t ta = MIN(arb_trailing_zeros(a->number, a->len), a->len - 1);
+	size_t tb = MIN(arb_trailing_zeros(b->number, b->len), b->len - 1);
+	size_t n = a->len + b->len - ta - tb;
+	size_t p = 0;
+	fxdpnt x[1] = { 0 };
+	fxdpnt y[1] = { 0 };
+	arb_view(x, a, 0, a->len - ta, a->len - ta);
+	arb_view(y, b, 0, b->len - tb, b->len - tb);
+
+	fxdpnt *c2 = NULL;
+
+	/* a zero may have no digits at all, which the split can not handle */
+	if (a->len == 0 || b->len == 0) {
+		c2 = arb_mul_exp(arb_mul2(a, b, NULL, base, (size_t)-1), ea, eb, scale);
+		arb_free(c);
+		return c2;
+	}
+
+	c2 = arb_expand(NULL, a->len + b->len + 3);
+	c2 = karatsuba(x, y, c2, base);
+
+	/* line the product up as the 'n' leading digits and zero the rest */
+	p = c2->len;
+	c2 = arb_expand(c2, a->len + b->len);
+	if (p >= n) {
+		memmove(c2->number, c2->number + p - n, n * sizeof(UARBT));
+	} else {
+		memmove(c2->number + n - p, c2->number, p * sizeof(UARBT));
+		_arb_memset(c2->number, 0, n - p);
+	}
+	_arb_memset(c2->number + n, 0, ta + tb);
 	arb_setsign(a, b, c2);
 	c2->lp = a->lp + b->lp;
-	c2->len = MIN(rr(a) + rr(b), MAX(scale, MAX(rr(a), rr(b)))) + c2->lp;
-	c2 = remove_leading_zeros(c2);
+	c2->len = a->len + b->len;
+	c2 = arb_mul_exp(c2, ea, eb, scale);
 	if (c)
 		arb_free(c);
 	return c2;
@@ -9,6 +9,8 @@ fxdpnt *arb_leftshift(fxdpnt *a, size_t n)
 	size_t k = 0;
 	size_t l = a->len -1;
 
+	a = arb_expand(a, a->len);
+
 	for (i = n-1;i < a->len-1; ++i, ++j, ++k)
 		a->number[k] = a->number[j];
 
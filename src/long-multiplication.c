@@ -16,8 +16,93 @@
 	arb_mul2() is a wrapper for arb_mul_core which provides memory
 	allocation but does not strip zeros like arb_mul. arb_mul2()
 	only calls the base case long multiplication algorithm.
+
+	When the base is a power of two the carries are split off of each
+	product with a shift and a mask instead of a division.
+
+	Trailing zeros of either operand are left out of the product and
+	written onto its end, so 1500000000 costs as much as 15.
+
+	Operands of ARB_MUL_TILED digits or more are multiplied a block of
+	columns of the product at a time instead of a row at a time. The
+	sums of the digit products of each column are kept in a small array
+	of words which stays in the L1 cache while the rows of 'a' sweep
+	over the matching window of 'b', and the carries are only split off
+	once per column, when the block is done. The blocked kernel is tried
+	first for every base, and splits its carries with a shift and a mask
+	too when the base is a power of two, so the row by row kernels only
+	see operands shorter than ARB_MUL_TILED.
 */
 
+#define ARB_MUL_TILE 256	/* columns of the product per block */
+#define ARB_MUL_TILED 6	/* shortest operand worth the blocked kernel */
+
+/* the product of 'a' and 'b' into c[0..alen+blen), which need not be
+   zeroed unless 'add' is set, in which case the product is added to the
+   digits already there and the carry out of c[0] is returned.
+   a[i] * b[j] lands in column i + j, which is c[i + j + 1] */
+static uint64_t _arb_mul_core_tiled(const UARBT *a, size_t alen, const UARBT *b, size_t blen, UARBT *c, int base, int add)
+{
+	int bits = arb_pow2base(base);
+	uint64_t mask = ((uint64_t)1 << bits) - 1;
+	uint32_t acc[ARB_MUL_TILE];
+	uint64_t carry = 0;
+	uint64_t t = 0;
+	size_t hi = alen + blen - 1;
+	size_t lo = 0;
+	size_t i = 0;
+	size_t j = 0;
+	size_t jlo = 0;
+	size_t jhi = 0;
+	size_t m = 0;
+
+	/* blocks of columns from the lowest up, each taking the carry of the
+	   one before */
+	for (; hi > 0; hi = lo) {
+		lo = hi > ARB_MUL_TILE ? hi - ARB_MUL_TILE : 0;
+		memset(acc, 0, (hi - lo) * sizeof(uint32_t));
+		/* the rows of 'a' which reach columns lo to hi - 1 */
+		for (i = lo >= blen ? lo - blen + 1 : 0; i < alen && i < hi; ++i) {
+			jlo = lo > i ? lo - i : 0;
+			jhi = MIN(blen, hi - i);
+			for (j = jlo; j < jhi; ++j)
+				acc[i + j - lo] += a[i] * b[j];
+		}
+		for (m = hi; m > lo; --m) {
+			t = acc[m - lo - 1] + carry + (add ? c[m] : 0);
+			if (bits) {
+				c[m] = t & mask;
+				carry = t >> bits;
+			} else {
+				c[m] = t % base;
+				carry = t / base;
+			}
+		}
+	}
+	t = carry + (add ? c[0] : 0);
+	c[0] = t % base;
+	return t / base;
+}
+
+static void _arb_mul_core_pow2(const UARBT *a, size_t alen, const UARBT *b, size_t blen, UARBT *c, int k)
+{
+	unsigned prod = 0;
+	unsigned carry = 0;
+	unsigned mask = (1u << k) - 1;
+	size_t i = 0;
+	size_t j = 0;
+	size_t l = 0;
+
+	for (i = alen; i > 0 ; i--){
+		for (j = blen, l = i + blen, carry = 0; j > 0 ; j--, l--){
+			prod = a[i-1] * b[j-1] + c[l-1] + carry;
+			carry = prod >> k;
+			c[l-1] = prod & mask;
+		}
+		c[l-1] = carry;
+	}
+}
+
 size_t arb_mul_core(const UARBT *a, size_t alen, const UARBT *b, size_t blen, UARBT *c, int base)
 {
 	UARBT prod = 0;
@@ -27,16 +112,36 @@ size_t arb_mul_core(const UARBT *a, size_t alen, const UARBT *b, size_t blen, UA
 	size_t k = 0;
 	size_t last = 0;
 	size_t ret = 0;
+	size_t ta = 0;
+	size_t tb = 0;
+	int bits = 0;
+
+	/* a zero may have no digits at all */
+	if (alen == 0 || blen == 0) {
+		_arb_memset(c, 0, alen + blen);
+		return 0;
+	}
 
 	c[0] = 0;
 	c[alen+blen-1] = 0;
 
 	/* move zeros onto the solution and reduce the mag of the operands */
-	for (;alen > 3 && ! a[alen-1]; ++ret) {
-		c[--alen + blen -1] = 0;
+	ta = MIN(arb_trailing_zeros(a, alen), alen - 1);
+	tb = MIN(arb_trailing_zeros(b, blen), blen - 1);
+	ret = ta + tb;
+	alen -= ta;
+	blen -= tb;
+	_arb_memset(c + alen + blen, 0, ret);
+
+	/* column sums are at most MIN(alen, blen) * (base - 1)^2 */
+	if (MIN(alen, blen) >= ARB_MUL_TILED && MIN(alen, blen) <= UINT32_MAX / (base * base)) {
+		_arb_mul_core_tiled(a, alen, b, blen, c, base, 0);
+		return ret;
 	}
-	for (;blen > 3 && ! b[blen-1]; ++ret) {
-		c[alen + --blen -1] = 0;
+
+	if ((bits = arb_pow2base(base))) {
+		_arb_mul_core_pow2(a, alen, b, blen, c, bits);
+		return ret;
 	}
 
 	/* outer loop -- first operand */
@@ -55,26 +160,105 @@ size_t arb_mul_core(const UARBT *a, size_t alen, const UARBT *b, size_t blen, UA
 
 fxdpnt *arb_mul(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, size_t scale)
 {
+	fxdpnt va[1] = { 0 };
+	fxdpnt vb[1] = { 0 };
+	fxdpnt *c2 = NULL;
+
 	/* use karatsuba multiplication if either operand is over 1000 digits */
 	if (MAX(a->len, b->len) > 1000)
 		return arb_karatsuba_mul(a, b, c, base, scale);
 
-	c = arb_mul2(a, b, c, base, scale);
-	c = remove_leading_zeros(c);
-	return c;
+	/* the operands may be views of the output, so check for aliasing here */
+	c2 = arb_aliases(c, a) || arb_aliases(c, b) ? NULL : c;
+
+	/* multiply the stored digits, and give the product the exponents */
+	arb_view(va, a, 0, a->len, a->lp);
+	arb_view(vb, b, 0, b->len, b->lp);
+	c2 = arb_mul2(va, vb, c2, base, (size_t)-1);
+	c2 = arb_mul_exp(c2, a, b, scale);
+	if (c2 != c)
+		arb_free(c);
+	return c2;
 }
 
 fxdpnt *arb_mul2(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, size_t scale)
 {
-	fxdpnt *c2 = arb_expand(NULL, a->len + b->len);
+	fxdpnt *c2 = arb_aliases(c, a) || arb_aliases(c, b) ? NULL : c;
+
+	/* the output is written over when it shares no digits with the inputs */
+	c2 = arb_expand(c2, a->len + b->len);
+	if (c2 == c) {
+		arb_init(c2);
+		_arb_memset(c2->number, 0, a->len + b->len);
+	}
 	arb_setsign(a, b, c2);
         arb_mul_core(a->number, a->len, b->number, b->len, c2->number, base);
         c2->lp = rl(a) + rl(b);
         c2->len = MIN(rr(a) + rr(b), MAX(scale, MAX(rr(a), rr(b)))) + c2->lp;
-        arb_free(c);
+	if (c2 != c)
+		arb_free(c);
         return c2;
 }
 
+/* d = a * b + c. the digits of 'c' are lined up in 'd' first and the
+   blocked kernel adds the product into them, so no product is formed on
+   its own. This needs 'c' to have the sign of the product, to be no
+   longer after the radix than the product is kept to, and the operands
+   to be short of karatsuba, and otherwise the product is added after */
+fxdpnt *arb_addmul(const fxdpnt *a, const fxdpnt *b, const fxdpnt *c, fxdpnt *d, int base, size_t scale)
+{
+	fxdpnt fa[1] = { 0 };
+	fxdpnt fb[1] = { 0 };
+	fxdpnt fc[1] = { 0 };
+	fxdpnt *d2 = NULL;
+	fxdpnt *t = NULL;
+	char sign = a->sign == b->sign ? '+' : '-';
+	size_t keep = 0;
+	size_t lp = 0;
+	size_t n = 0;
+	size_t k = 0;
+	uint64_t carry = 0;
+
+	d2 = arb_aliases(d, a) || arb_aliases(d, b) || arb_aliases(d, c) ? NULL : d;
+	a = arb_flat(a, fa);
+	b = arb_flat(b, fb);
+	c = arb_flat(c, fc);
+	keep = MIN(rr(a) + rr(b), MAX(scale, MAX(rr(a), rr(b))));
+
+	if ((c->sign != sign && iszero(c)) || rr(c) > keep || !a->len || !b->len ||
+	    MAX(a->len, b->len) > 1000 || MIN(a->len, b->len) > UINT32_MAX / (base * base)) {
+		t = arb_mul(a, b, NULL, base, scale);
+		d2 = arb_add(t, c, d2, base);
+		arb_free(t);
+		goto end;
+	}
+
+	/* one more digit before the radix than either holds, for the carry */
+	lp = MAX(rl(a) + rl(b), rl(c)) + 1;
+	n = lp + rr(a) + rr(b);
+	d2 = arb_expand(d2, n);
+	arb_init(d2);
+	_arb_memset(d2->number, 0, n);
+	memcpy(d2->number + lp - rl(c), c->number, c->len * sizeof(UARBT));
+	k = lp - rl(a) - rl(b);
+	carry = _arb_mul_core_tiled(a->number, a->len, b->number, b->len, d2->number + k, base, 1);
+	for (; carry; carry /= base) {
+		carry += d2->number[--k];
+		d2->number[k] = carry % base;
+	}
+	d2->sign = iszero(c) ? c->sign : sign;
+	d2->lp = lp;
+	d2->len = lp + keep;
+	d2 = remove_leading_zeros(d2);
+	end:
+	arb_release(fa);
+	arb_release(fb);
+	arb_release(fc);
+	if (d2 != d)
+		arb_free(d);
+	return d2;
+}
+
 void mul(const fxdpnt *a, const fxdpnt *b, fxdpnt **c, int base, size_t scale, char *m)
 {
 	_internal_debug;
@@ -110,20 +110,17 @@
 
 */
 
-static fxdpnt *factor(fxdpnt *a, fxdpnt *b, int base, size_t scale)
+static fxdpnt *factor(fxdpnt *a, fxdpnt *b, int base)
 {
 	/* regular factorization. we only need to obtain two
 	   digit numbers
 	   TODO: make this function return the squared number 
 	   so we can save a multiplication later
 	*/
-	fxdpnt *temp = arb_str2fxdpnt("+0.00");
-	temp = arb_copy(temp, a);
 	int comp = -100;
 	do
 	{
-		mul(a, a, &temp, base, scale, 0);
-		comp = arb_compare(temp, b);
+		comp = arb_cmp_sqr(a, b, base);
 		if (comp == 0) {
 			break;
 		} else if (comp > 0) {
@@ -132,14 +129,13 @@ static fxdpnt *factor(fxdpnt *a, fxdpnt *b, int base, size_t scale)
 		}
 		incr(&a, base, 0);
 	}while (1);
-	arb_free(temp);
 	return a;
 }
 
 /* factor2() and push2() are convenience wrappers */
-static void factor2(fxdpnt **a, fxdpnt *b, int base, size_t scale)
+static void factor2(fxdpnt **a, fxdpnt *b, int base)
 {
-	*a = factor(*a, b, base, scale);
+	*a = factor(*a, b, base);
 }
 
 static fxdpnt *push(fxdpnt *c, fxdpnt *b)
@@ -158,7 +154,7 @@ static void push2(fxdpnt **c, fxdpnt *b, char *m)
 	_internal_debug_end;
 }
 
-static fxdpnt *guess(fxdpnt **c, fxdpnt *b, int base, size_t scale, char *m)
+static fxdpnt *guess(fxdpnt **c, fxdpnt *b, int base, char *m)
 {
 	/* Handle sqrt factorization guesses of the form:
 		465n * n < guess
@@ -183,13 +179,13 @@ static fxdpnt *guess(fxdpnt **c, fxdpnt *b, int base, size_t scale, char *m)
 			may be slow for large bases.
 	*/
 	_internal_debug;
-	fxdpnt *side = arb_str2fxdpnt("1");
-	fxdpnt *tmul = arb_str2fxdpnt("1");
+	fxdpnt *side = arb_copy(NULL, one);
 	int comp = -100;
 	do
 	{
-		mul(*c, side, &tmul, base, scale, 0);
-		comp = arb_compare(tmul, b);
+		/* the product is only formed when its leading digits are not
+		   enough to tell */
+		comp = arb_cmp_mul(*c, side, b, base);
 		if (comp == 0) {
 			break;
 		} else if (comp > 0) {
@@ -200,7 +196,6 @@ static fxdpnt *guess(fxdpnt **c, fxdpnt *b, int base, size_t scale, char *m)
 		incr(&side, base, 0);
 		incr(&*c, base, 0);
 	}while(1);
-	arb_free(tmul);
 	_internal_debug_end;
 	return side;
 }
@@ -216,8 +211,20 @@ fxdpnt *lhsqrt(fxdpnt *aa, int base, size_t scale)
 	int odd = 0;
 	int lodd = 0;
 	fxdpnt *a = NULL;
+	fxdpnt *hit = NULL;
+
+	if (_arb_memo_budget && (hit = arb_memo_get(ARB_MEMO_LHSQRT, aa, NULL, base, scale, aa)))
+		return hit;
+
 	a = arb_copy(a, aa);
+	a = arb_flatten(a);
 	a = remove_leading_zeros(a);
+	/* a zero may have no digits at all, which the loop below can not
+	   take apart, and it is its own root */
+	if (iszero(a) == 0) {
+		arb_free(aa);
+		return a;
+	}
 	//size_t suppl = MAX((scale*2), rr(a)* 2);
 	size_t suppl = MAX((scale * 2), rr(a));
 	fxdpnt *g1 = arb_expand(NULL, a->len);
@@ -228,9 +235,9 @@ fxdpnt *lhsqrt(fxdpnt *aa, int base, size_t scale)
 	arb_init(answer);
 	fxdpnt *g2 = NULL;
 
-	fxdpnt *x1 = arb_expand(NULL, a->len);
-	fxdpnt *tmp = x1;
-	UARBT *f = tmp->number;
+	fxdpnt *tmp = arb_expand(NULL, a->len);
+	fxdpnt *x1 = tmp;
+	fxdpnt win[1] = { 0 };
 
 	if (oddity(a->lp)) {
 		dig2get = 1;
@@ -262,12 +269,11 @@ fxdpnt *lhsqrt(fxdpnt *aa, int base, size_t scale)
 			x1->lp = x1->len = dig2get;
 		}
 		else if (i < a->len -1) {
-			x1->number = a->number + i;
-			x1->lp = x1->len = dig2get;
+			x1 = arb_view(win, a, i, dig2get, dig2get);
 		}
 		// TODO: separate out this conditional
 		if (firstpass) {
-			factor2(&g1, x1, base, scale);
+			factor2(&g1, x1, base);
 			push2(&answer, g1, "answer = ");
 			mul(g1, g1, &g1, base, scale, "g1 = ");
 			sub(x1, g1, &g1, base, "g1 = ");
@@ -275,9 +281,9 @@ fxdpnt *lhsqrt(fxdpnt *aa, int base, size_t scale)
 		}else {
 			push2(&g1, x1, "g1 = ");
 			/* mul by 2, append, and then factor up */
-			mul(answer, two, &side, base, scale, "side = ");
+			side = arb_mul_ui(answer, 2, side, base);
 			push2(&side, one, "side = ");
-			t = guess(&side, g1, base, scale, "side = ");
+			t = guess(&side, g1, base, "side = ");
 			debugmul(t, side, &g2, base, scale, "g2 =");
 			push2(&answer, t, "answer = ");
 			arb_free(t);
@@ -291,11 +297,15 @@ fxdpnt *lhsqrt(fxdpnt *aa, int base, size_t scale)
 	arb_free(g1);
 	arb_free(g2);
 	arb_free(side);
-	tmp->number = f;
 	arb_free(tmp);
-	answer = arb_rightshift(answer, zeros / 2);
+	/* the root's leading fractional zeros are held in its exponent */
+	answer->exp = -(long)(zeros / 2);
 	answer->lp = a->lp / 2 + lodd;
-	answer->len = answer->lp + MAX(scale, rr(a));
+	answer->len = answer->lp + MAX(scale, rr(a)) - zeros / 2;
+	answer = remove_leading_zeros(answer);
+	/* 'a' has the value and the scale of 'aa' */
+	if (_arb_memo_budget)
+		arb_memo_put(ARB_MEMO_LHSQRT, a, NULL, base, scale, answer);
 	arb_free(a);
 	arb_free(aa);
 	
@@ -32,8 +32,9 @@
 		with no whole number part and many many leading zeros about
 		20 percent of the time.
 
-		TODO: create numbers with huge expanses of zeros such as
-		123.0000000....0000123
+		Numbers with huge expanses of zeros such as 123.000...000123
+		or 123000...000 are also made, about 15 percent of the time,
+		as they exercise arbitraire's exponents.
 
 	3> Invalid numbers are also generated. Such as:
 		-.
@@ -115,6 +116,16 @@ char *make_bignum(size_t limit, int base, int tryneg)
 
 		for(;i < truelim; i++)
 			ret[i] = arb_highbase((random() % base));
+	/* numbers with a long run of zeros somewhere inside of them */
+	} else if (random() % 5 == 1) {
+		size_t start = i + random() % (truelim - i);
+		size_t zeros = random() % (truelim - start + 1);
+		for(;i < truelim; i++)
+			ret[i] = arb_highbase((random() % base));
+		memset(ret + start, '0', zeros);
+		/* the radix may come before, within or after the run */
+		if (random() % 3)
+			ret[MIN(start + random() % (zeros + 1), truelim - 1)] = '.';
 	/* numbers that will typically have whole-number values */
 	} else {
 		for(;i < truelim; i++)
@@ -0,0 +1,292 @@
+#include "internal.h"
+
+#include <pthread.h>
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	The memo cache remembers the results of expensive operations (arb_div,
+	arb_mod, nsqrt and lhsqrt) so that calling one again with the same
+	operands, base and scale is a lookup and a copy.
+
+	It is off until arb_memo_enable() gives it a budget in bytes, which
+	covers the entries and the digits of the numbers they hold. Once the
+	budget is spent the least recently used entries are dropped.
+	arb_memo_enable(0) turns the cache off and empties it. Turning the
+	cache on or off must not race with other threads using arbitraire.
+
+	Operands are matched by value and by scale, because the scale of an
+	operand can change the scale of a result (as with arb_mod). Entries
+	keep private copies of their numbers, so numbers given to or taken
+	from the cache never share digits with it.
+
+	Only the calls made by the program are cached. The library's own
+	divisions, such as those of each Newton step in nsqrt or inside
+	arb_mod, go through arb_div_nomemo() so that they neither evict the
+	program's entries nor count as hits and misses.
+
+	The cache is split into ARB_MEMO_SHARDS shards by the hash of the key,
+	each with its own lock, least recently used list and share of the
+	budget, so that threads seldom wait on each other.
+*/
+
+#define ARB_MEMO_SHARDS 16
+#define ARB_MEMO_SEED 0x6D656D6FULL
+
+typedef struct arb_memo_entry {
+	uint64_t key;
+	int op;
+	int base;
+	size_t scale;
+	fxdpnt *a;
+	fxdpnt *b;
+	fxdpnt *r;
+	size_t bytes;
+	struct arb_memo_entry *chain;	/* next in the same bucket */
+	struct arb_memo_entry *prev;	/* more recently used */
+	struct arb_memo_entry *next;	/* less recently used */
+} arb_memo_entry;
+
+typedef struct {
+	pthread_mutex_t lock;
+	arb_memo_entry **bucket;
+	size_t nbucket;
+	size_t n;
+	arb_memo_entry *head;
+	arb_memo_entry *tail;
+	size_t bytes;
+	size_t hits;
+	size_t misses;
+} arb_memo_shard;
+
+static arb_memo_shard _arb_memo[ARB_MEMO_SHARDS];
+static pthread_once_t _arb_memo_once = PTHREAD_ONCE_INIT;
+
+/* the budget of each shard, zero when the cache is off */
+size_t _arb_memo_budget = 0;
+
+static void _arb_memo_init(void)
+{
+	size_t i = 0;
+	for (; i < ARB_MEMO_SHARDS; ++i)
+		pthread_mutex_init(&_arb_memo[i].lock, NULL);
+}
+
+/* the count of fractional digits of 'a' */
+static size_t _arb_memo_scale(const fxdpnt *a)
+{
+	long s = (long)rr(a) - a->exp;
+	return s > 0 ? s : 0;
+}
+
+static size_t _arb_memo_size(const fxdpnt *a)
+{
+	return a ? sizeof(fxdpnt) + a->allocated * sizeof(UARBT) : 0;
+}
+
+static uint64_t _arb_memo_key(int op, const fxdpnt *a, const fxdpnt *b, int base, size_t scale)
+{
+	uint64_t k = arb_hash(a, ARB_MEMO_SEED);
+	k = k * 31 + (b ? arb_hash(b, ARB_MEMO_SEED) : 0);
+	k = k * 31 + _arb_memo_scale(a) + (b ? _arb_memo_scale(b) << 20 : 0);
+	k = k * 31 + scale;
+	k = k * 31 + ((uint64_t)base << 8) + op;
+	/* mix again so that the shard and bucket bits are well spread */
+	k ^= k >> 31;
+	k *= 0x9E3779B97F4A7C15ULL;
+	k ^= k >> 29;
+	return k;
+}
+
+static int _arb_memo_same(const fxdpnt *x, const fxdpnt *y)
+{
+	if (!x || !y)
+		return x == y;
+	return arb_compare(x, y) == 0 && _arb_memo_scale(x) == _arb_memo_scale(y);
+}
+
+static void _arb_memo_unlink(arb_memo_shard *s, arb_memo_entry *e)
+{
+	if (e->prev)
+		e->prev->next = e->next;
+	else
+		s->head = e->next;
+	if (e->next)
+		e->next->prev = e->prev;
+	else
+		s->tail = e->prev;
+	e->prev = e->next = NULL;
+}
+
+static void _arb_memo_front(arb_memo_shard *s, arb_memo_entry *e)
+{
+	e->next = s->head;
+	if (s->head)
+		s->head->prev = e;
+	s->head = e;
+	if (!s->tail)
+		s->tail = e;
+}
+
+static void _arb_memo_drop(arb_memo_shard *s, arb_memo_entry *e)
+{
+	arb_memo_entry **p = &s->bucket[e->key & (s->nbucket - 1)];
+
+	for (; *p != e; p = &(*p)->chain)
+		;
+	*p = e->chain;
+	_arb_memo_unlink(s, e);
+	s->bytes -= e->bytes;
+	s->n--;
+	arb_free(e->a);
+	arb_free(e->b);
+	arb_free(e->r);
+	arb_dealloc(e);
+}
+
+static void _arb_memo_rehash(arb_memo_shard *s)
+{
+	size_t nb = s->nbucket ? s->nbucket * 2 : 64;
+	arb_memo_entry **b = arb_calloc(nb, sizeof(arb_memo_entry *));
+	arb_memo_entry *e = NULL;
+	arb_memo_entry *next = NULL;
+	size_t i = 0;
+
+	for (; i < s->nbucket; ++i) {
+		for (e = s->bucket[i]; e; e = next) {
+			next = e->chain;
+			e->chain = b[e->key & (nb - 1)];
+			b[e->key & (nb - 1)] = e;
+		}
+	}
+	arb_dealloc(s->bucket);
+	s->bucket = b;
+	s->nbucket = nb;
+}
+
+static arb_memo_shard *_arb_memo_shard(uint64_t key)
+{
+	return &_arb_memo[(key >> 56) % ARB_MEMO_SHARDS];
+}
+
+fxdpnt *arb_memo_get(int op, const fxdpnt *a, const fxdpnt *b, int base, size_t scale, fxdpnt *c)
+{
+	uint64_t key = _arb_memo_key(op, a, b, base, scale);
+	arb_memo_shard *s = _arb_memo_shard(key);
+	arb_memo_entry *e = NULL;
+	fxdpnt *ret = NULL;
+
+	pthread_mutex_lock(&s->lock);
+	if (s->nbucket)
+		e = s->bucket[key & (s->nbucket - 1)];
+	for (; e; e = e->chain) {
+		if (e->key == key && e->op == op && e->base == base &&
+		    e->scale == scale && _arb_memo_same(e->a, a) &&
+		    _arb_memo_same(e->b, b))
+			break;
+	}
+	if (e) {
+		_arb_memo_unlink(s, e);
+		_arb_memo_front(s, e);
+		/* a deep copy, the digits of an entry are never shared */
+		ret = _arb_copy_digits(c, e->r);
+		s->hits++;
+	} else {
+		s->misses++;
+	}
+	pthread_mutex_unlock(&s->lock);
+	return ret;
+}
+
+void arb_memo_put(int op, const fxdpnt *a, const fxdpnt *b, int base, size_t scale, const fxdpnt *r)
+{
+	uint64_t key = _arb_memo_key(op, a, b, base, scale);
+	arb_memo_shard *s = _arb_memo_shard(key);
+	arb_memo_entry *e = NULL;
+	size_t budget = _arb_memo_budget;
+
+	if (r == NULL || budget == 0)
+		return;
+
+	/* the copies are made outside of the lock */
+	e = arb_malloc(sizeof(arb_memo_entry));
+	e->key = key;
+	e->op = op;
+	e->base = base;
+	e->scale = scale;
+	e->a = _arb_copy_digits(NULL, a);
+	e->b = b ? _arb_copy_digits(NULL, b) : NULL;
+	e->r = _arb_copy_digits(NULL, r);
+	e->bytes = sizeof(arb_memo_entry) + _arb_memo_size(e->a) +
+		   _arb_memo_size(e->b) + _arb_memo_size(e->r);
+	e->prev = e->next = NULL;
+
+	if (e->bytes > budget) {
+		arb_free(e->a);
+		arb_free(e->b);
+		arb_free(e->r);
+		arb_dealloc(e);
+		return;
+	}
+
+	pthread_mutex_lock(&s->lock);
+	while (s->tail && s->bytes + e->bytes > budget)
+		_arb_memo_drop(s, s->tail);
+	if (s->n >= s->nbucket)
+		_arb_memo_rehash(s);
+	e->chain = s->bucket[key & (s->nbucket - 1)];
+	s->bucket[key & (s->nbucket - 1)] = e;
+	_arb_memo_front(s, e);
+	s->bytes += e->bytes;
+	s->n++;
+	pthread_mutex_unlock(&s->lock);
+}
+
+void arb_memo_clear(void)
+{
+	size_t i = 0;
+	arb_memo_shard *s = NULL;
+
+	pthread_once(&_arb_memo_once, _arb_memo_init);
+	for (; i < ARB_MEMO_SHARDS; ++i) {
+		s = &_arb_memo[i];
+		pthread_mutex_lock(&s->lock);
+		while (s->tail)
+			_arb_memo_drop(s, s->tail);
+		arb_dealloc(s->bucket);
+		s->bucket = NULL;
+		s->nbucket = 0;
+		pthread_mutex_unlock(&s->lock);
+	}
+}
+
+void arb_memo_enable(size_t bytes)
+{
+	pthread_once(&_arb_memo_once, _arb_memo_init);
+	_arb_memo_budget = bytes / ARB_MEMO_SHARDS;
+	if (_arb_memo_budget == 0)
+		arb_memo_clear();
+}
+
+void arb_memo_stats(size_t *hits, size_t *misses, size_t *bytes)
+{
+	size_t h = 0;
+	size_t m = 0;
+	size_t b = 0;
+	size_t i = 0;
+
+	pthread_once(&_arb_memo_once, _arb_memo_init);
+	for (; i < ARB_MEMO_SHARDS; ++i) {
+		pthread_mutex_lock(&_arb_memo[i].lock);
+		h += _arb_memo[i].hits;
+		m += _arb_memo[i].misses;
+		b += _arb_memo[i].bytes;
+		pthread_mutex_unlock(&_arb_memo[i].lock);
+	}
+	if (hits)
+		*hits = h;
+	if (misses)
+		*misses = m;
+	if (bytes)
+		*bytes = b;
+}
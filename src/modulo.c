@@ -6,17 +6,45 @@
 /*
  * This is a basic modulus operation which naturally handles fractional
  * arguments using the formula: modulus(a, b) = a - (b * (a / b))
+ *
+ * Integers modulo a word at a scale of zero go to arb_mod_ui, which
+ * needs no quotient.
 */
 
+/* whether 'a' has no fractional digits */
+static int _arb_isint(const fxdpnt *a)
+{
+	return (long)rr(a) - a->exp <= 0;
+}
+
 
 fxdpnt *arb_mod(const fxdpnt *a, const fxdpnt *b, fxdpnt *c, int base, size_t scale)
 {
-	size_t newscale = MAX(a->len, b->len + scale);
-	fxdpnt *tmp = arb_expand(NULL, newscale);
-	tmp = arb_div(a, b, tmp, base, scale);
+	fxdpnt *hit = NULL;
+	int64_t w = 0;
+	char sign = a->sign;
+
+	if (scale == 0 && _arb_isint(a) && _arb_isint(b) &&
+	    arb_to_i64(b, &w, base) == 0 && w) {
+		c = arb_from_u64(arb_mod_ui(a, w < 0 ? 0 - (uint64_t)w : (uint64_t)w, base), c, base);
+		if (iszero(c))
+			c->sign = sign;
+		return c;
+	}
+
+	if (_arb_memo_budget && (hit = arb_memo_get(ARB_MEMO_MOD, a, b, base, scale, c)))
+		return hit;
+
+	/* the product of the quotient and b is kept whole */
+	size_t newscale = scale + arb_rr(b);
+	fxdpnt *tmp = arb_div_nomemo(a, b, NULL, base, scale);
 	tmp = arb_mul(tmp, b, tmp, base, newscale);
-	c = arb_sub(a, tmp, c, base);
+	/* the result is kept before 'c', which may be 'a' or 'b', goes */
+	fxdpnt *c2 = arb_sub(a, tmp, NULL, base);
+	if (_arb_memo_budget)
+		arb_memo_put(ARB_MEMO_MOD, a, b, base, scale, c2);
+	arb_free(c);
 	arb_free(tmp);
-	return c;
+	return c2;
 }
 
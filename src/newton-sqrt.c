@@ -14,33 +14,52 @@ fxdpnt *nsqrt(fxdpnt *a, int base, size_t scale)
 	size_t s1 = 0;
 	size_t s2 = 2;
 	
-	fxdpnt *g = arb_str2fxdpnt("10");
+	fxdpnt *g = NULL;
 	fxdpnt *g1 = NULL;
+	fxdpnt *key = NULL;
+	fxdpnt *hit = NULL;
 
 	
+	if (iszero(a) == 0)
+		return remove_leading_zeros(a);
 	if (a->sign == '-')
 		return NULL;
+
+	/* 'a' is written over by the root, so the cache gets a copy */
+	if (_arb_memo_budget) {
+		if ((hit = arb_memo_get(ARB_MEMO_NSQRT, a, NULL, base, scale, a)))
+			return hit;
+		key = arb_copy(NULL, a);
+	}
+
+	a = arb_flatten(a);
 	
+	/* the first guess is 1 followed by half as many digits as 'a' has */
 	if ((a->lp)<2){
 		g = arb_copy(g, one);
 	}
 	else {
 		g = arb_expand_inter(g, a->lp / 2, a->lp / 2, 1);
+		g->number[0] = 1;
 	}
 
 	for(s1 = MAX(rr(a), scale);;) {
-		g1 = arb_copy(g1, g);
-		g = arb_div(a, g, g, base, s1);
+		g1 = arb_share(g1, g);
+		g = arb_div_nomemo(a, g, g, base, s1);
 		g = arb_add(g, g1, g, base);
-		g = arb_mul(g, p5, g, base, s1);
-		if ((arb_compare(g, g1) == 0)) {
+		g = arb_divmod_ui(g, 2, g, NULL, base, s1);
+		if (arb_equal(g, g1)) {
 			if (s2 < s1+1)
 				s2 = MIN(s2*3, s1+1);
 			else
 				break;
 		}
 	}
-	a = arb_div(g, one, a, base, s1);
+	a = arb_div_nomemo(g, one, a, base, s1);
+	if (key) {
+		arb_memo_put(ARB_MEMO_NSQRT, key, NULL, base, scale, a);
+		arb_free(key);
+	}
 
 	arb_free(g);
 	arb_free(g1);
@@ -33,10 +33,10 @@ fxdpnt *arb_newtonian_div(fxdpnt *a, fxdpnt *b, fxdpnt *c, int base, int scale,
 		hold = arb_mul(b, g, hold, base, scale);
 		hold = arb_sub(two, hold, hold, base);
 		g1 = arb_mul(g, hold, g1, base, scale);
-		if (arb_compare(g, g1) == 0) {
+		if (arb_equal(g, g1)) {
 			break;
 		}
-		g = arb_copy(g, g1);
+		g = arb_share(g, g1);
 	} 
 	c = arb_mul(g, a, c, base, scale); 
 
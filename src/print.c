@@ -55,6 +55,12 @@ void arb_fprint(FILE *fp, const fxdpnt *flt)
 		fputs("number was (null)\n", fp);
 		return;
 	}
+	if (flt->exp) {
+		fxdpnt tmp[1] = { 0 };
+		arb_fprint(fp, arb_flat(flt, tmp));
+		arb_release(tmp);
+		return;
+	}
 	if (iszero(flt) == 0) {
 		fputc('0', fp);
 		fputc('\n', fp);
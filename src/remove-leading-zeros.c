@@ -2,20 +2,65 @@
 
 /* Copyright 2017-2019 CM Graff */
 
+/*
+	remove_leading_zeros() is the last step of every public operation, and
+	so it also puts the number into the canonical form used by arb_compare,
+	arb_equal and iszero. A canonical number has no redundant leading zeros
+	and records the length of its digits without their trailing zeros in
+	'sig'. Trailing zeros are kept as they carry the scale of the number.
+
+	The canonical flag is cleared by arb_expand_inter and arb_init, which
+	every routine that writes to an existing number goes through.
+
+	An exponent which only moves the radix within the stored digits is
+	folded back into 'lp' so that results are flat whenever that is free.
+
+	arb_trailing_zeros() counts the zeros at the end of a run of digits a
+	word at a time, for the kernels which leave them out of their work.
+*/
+
+size_t arb_trailing_zeros(const UARBT *d, size_t n)
+{
+	size_t t = 0;
+	uint64_t w = 0;
+
+	for (; n - t >= sizeof(w); t += sizeof(w)) {
+		memcpy(&w, d + n - t - sizeof(w), sizeof(w));
+		if (w)
+			break;
+	}
+	for (; t < n && !d[n - t - 1]; ++t)
+		;
+	return t;
+}
+
 fxdpnt *remove_leading_zeros(fxdpnt *c)
 {
 	int effect = 0;
 	size_t i = 0;
+	long r = (long)c->lp + c->exp;
+
+	if (c->exp && r >= 0 && (size_t)r <= c->len) {
+		c->lp = r;
+		c->exp = 0;
+	}
 	
-	for (i=0;c->number[i] == 0 && (c->lp > 1 || (c->lp > 0 && rr(c)));) { 
+	for (i = 0; c->number[i] == 0 && (c->lp > 1 || (c->lp > 0 && c->len - i > c->lp));) {
 		c->lp--;
 		++i;
 		effect = 1;
 	}
 
-	if (effect) {
+	/* a view can simply be repointed past its zeros */
+	if (effect && (c->flags & ARB_VIEW)) {
+		c->number += i;
+		c->len -= i;
+	} else if (effect) {
 		c = arb_leftshift(c, i);
 		c->len -= i;
 	}
+
+	c->sig = c->len - arb_trailing_zeros(c->number, c->len);
+	c->flags |= ARB_CANON;
 	return c;
 }
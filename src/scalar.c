@@ -0,0 +1,426 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	Operations between a number and a machine word.
+
+	These work in place on their destination, which may be the same
+	number as the input, in a single pass over the digits and without
+	allocating. arb_add_ui and arb_sub_ui usually only touch the low
+	digits of the integer part. The destination only grows when a carry
+	runs off of its top.
+
+	When the result crosses zero, or the word is too large to be worked
+	on a digit at a time, the word is put into a number on the stack and
+	the general routines are used instead.
+
+	arb_divmod_ui truncates the quotient to 'scale' digits like arb_div.
+	When 'rem' is not NULL it receives the magnitude of the remainder of
+	that division in units of base^-scale, so for integers at a scale of
+	zero it is simply |a| % w.
+
+	In a base of 2^bits the word is split into digits, and products into
+	digit and carry, with shifts and masks. Division by a word which is a
+	power of two is a shift and a mask as well, in any base.
+*/
+
+/* the largest number of digits a word can have (in base 2) */
+#define ARB_WORD_DIG (sizeof(size_t) * CHAR_BIT)
+
+/* put 'w' into a number on the stack which uses 'buf' for its digits */
+static const fxdpnt *_arb_word(fxdpnt *t, UARBT *buf, size_t w, int base)
+{
+	size_t i = ARB_WORD_DIG;
+	int bits = arb_pow2base(base);
+
+	do {
+		buf[--i] = bits ? w & (base - 1) : w % base;
+		w = bits ? w >> bits : w / base;
+	} while (w);
+	t->number = buf + i;
+	t->len = t->lp = ARB_WORD_DIG - i;
+	t->sign = '+';
+	t->allocated = 0;
+	t->flags = ARB_VIEW;
+	t->refs = NULL;
+	t->exp = 0;
+	return t;
+}
+
+static size_t _arb_word_len(size_t w, int base)
+{
+	size_t n = 1;
+	int bits = arb_pow2base(base);
+
+	for (; w >= (size_t)base; w = bits ? w >> bits : w / base)
+		++n;
+	return n;
+}
+
+/* prepend 'n' zeros to the integer part of 'c' */
+static fxdpnt *_arb_grow(fxdpnt *c, size_t n)
+{
+	size_t len = c->len;
+	c = arb_expand(c, len + n);
+	memmove(c->number + n, c->number, len * sizeof(UARBT));
+	_arb_memset(c->number, 0, n);
+	c->len = len + n;
+	c->lp += n;
+	return c;
+}
+
+/* get 'c' ready to be written to in place */
+static fxdpnt *_arb_dest(const fxdpnt *a, fxdpnt *c)
+{
+	if (c != a)
+		c = arb_copy(c, a);
+	return arb_expand(c, c->len);
+}
+
+/* |c| += w */
+static fxdpnt *_arb_uadd_ui(fxdpnt *c, size_t w, int base)
+{
+	size_t i = 0;
+	UARBT cy = 0;
+	ARBT s = 0;
+	size_t n = _arb_word_len(w, base);
+	int bits = arb_pow2base(base);
+
+	if (c->lp < n)
+		c = _arb_grow(c, n - c->lp);
+	for (i = c->lp; (w || cy) && i > 0; w = bits ? w >> bits : w / base) {
+		s = c->number[--i] + (bits ? w & (base - 1) : w % base) + cy;
+		cy = s >= base;
+		c->number[i] = cy ? s - base : s;
+	}
+	if (cy) {
+		c = _arb_grow(c, 1);
+		c->number[0] = 1;
+	}
+	return c;
+}
+
+/* |c| -= w, where |c| >= w */
+static fxdpnt *_arb_usub_ui(fxdpnt *c, size_t w, int base)
+{
+	size_t i = 0;
+	UARBT br = 0;
+	ARBT s = 0;
+	int bits = arb_pow2base(base);
+
+	for (i = c->lp; (w || br) && i > 0; w = bits ? w >> bits : w / base) {
+		s = c->number[--i] - (ARBT)(bits ? w & (base - 1) : w % base) - br;
+		br = s < 0;
+		c->number[i] = br ? s + base : s;
+	}
+	return c;
+}
+
+/* compare |c| to w */
+static int _arb_ucmp_ui(fxdpnt *c, size_t w, int base)
+{
+	UARBT buf[ARB_WORD_DIG];
+	fxdpnt t[1] = { 0 };
+	char sign = c->sign;
+	int ret = 0;
+
+	c->sign = '+';
+	ret = arb_compare(c, _arb_word(t, buf, w, base));
+	c->sign = sign;
+	return ret;
+}
+
+static fxdpnt *_arb_finish(fxdpnt *c)
+{
+	c = remove_leading_zeros(c);
+	if (c->sig == 0)
+		c->sign = '+';
+	return c;
+}
+
+fxdpnt *arb_add_ui(const fxdpnt *a, size_t w, fxdpnt *c, int base)
+{
+	UARBT buf[ARB_WORD_DIG];
+	fxdpnt t[1] = { 0 };
+
+	c = arb_flatten(_arb_dest(a, c));
+	if (c->sign == '+')
+		c = _arb_uadd_ui(c, w, base);
+	else if (_arb_ucmp_ui(c, w, base) >= 0)
+		c = _arb_usub_ui(c, w, base);
+	else
+		return arb_add(c, _arb_word(t, buf, w, base), c, base);
+	return _arb_finish(c);
+}
+
+fxdpnt *arb_sub_ui(const fxdpnt *a, size_t w, fxdpnt *c, int base)
+{
+	UARBT buf[ARB_WORD_DIG];
+	fxdpnt t[1] = { 0 };
+
+	c = arb_flatten(_arb_dest(a, c));
+	if (c->sign == '-')
+		c = _arb_uadd_ui(c, w, base);
+	else if (_arb_ucmp_ui(c, w, base) >= 0)
+		c = _arb_usub_ui(c, w, base);
+	else
+		return arb_sub(c, _arb_word(t, buf, w, base), c, base);
+	return _arb_finish(c);
+}
+
+fxdpnt *arb_mul_ui(const fxdpnt *a, size_t w, fxdpnt *c, int base)
+{
+	UARBT buf[ARB_WORD_DIG];
+	fxdpnt t[1] = { 0 };
+	size_t i = 0;
+	size_t p = 0;
+	size_t cy = 0;
+	size_t n = 0;
+	int bits = arb_pow2base(base);
+
+	if (w > SIZE_MAX / base)
+		return arb_mul(a, _arb_word(t, buf, w, base), c, base, 0);
+
+	/* the exponent of 'a' carries over to the product unchanged */
+	c = _arb_dest(a, c);
+	if (bits) {
+		for (i = c->len; i > 0; cy = p >> bits) {
+			p = c->number[--i] * w + cy;
+			c->number[i] = p & (base - 1);
+		}
+	} else {
+		for (i = c->len; i > 0; cy = p / base) {
+			p = c->number[--i] * w + cy;
+			c->number[i] = p % base;
+		}
+	}
+	if (cy) {
+		n = _arb_word_len(cy, base);
+		c = _arb_grow(c, n);
+		for (i = n; i > 0; cy = bits ? cy >> bits : cy / base)
+			c->number[--i] = bits ? cy & (base - 1) : cy % base;
+	}
+	return _arb_finish(c);
+}
+
+fxdpnt *arb_divmod_ui(const fxdpnt *a, size_t w, fxdpnt *c, size_t *rem, int base, size_t scale)
+{
+	UARBT buf[ARB_WORD_DIG];
+	fxdpnt t[1] = { 0 };
+	size_t i = 0;
+	size_t r = 0;
+	size_t len = 0;
+	int k = 0;
+	int bits = 0;
+
+	if (w == 0) {
+		fputs("Divide by zero\n", stderr);
+		return NULL;
+	}
+
+	if (w > SIZE_MAX / base) {
+		fxdpnt fa[1] = { 0 };
+		fxdpnt v[1] = { 0 };
+		fxdpnt *q = NULL;
+		fxdpnt *d = NULL;
+		const fxdpnt *f = arb_flat(a, fa);
+		_arb_word(t, buf, w, base);
+		q = arb_div_nomemo(f, t, NULL, base, scale);
+		if (rem) {
+			/* |a| truncated to the scale, less |q| * w */
+			arb_view(v, f, 0, MIN(f->len, f->lp + scale), f->lp);
+			v->sign = '+';
+			d = arb_mul(q, t, NULL, base, scale);
+			d->sign = '+';
+			d = arb_sub(v, d, d, base);
+			d = arb_shift_radix(d, scale);
+			*rem = fxd2sizet(d, base);
+			arb_free(d);
+		}
+		arb_release(fa);
+		arb_free(c);
+		return q;
+	}
+
+	c = arb_flatten(_arb_dest(a, c));
+	len = c->len;
+	c = arb_expand(c, c->lp + scale);
+	if (len < c->lp + scale)
+		_arb_memset(c->number + len, 0, c->lp + scale - len);
+	c->len = c->lp + scale;
+
+	/* digits past the scale do not change the truncated quotient */
+	for (k = 0; (w & (w - 1)) == 0 && ((size_t)1 << k) < w; ++k)
+		;
+	if ((w & (w - 1)) == 0 && (bits = arb_pow2base(base))) {
+		for (i = 0; i < c->len; ++i) {
+			r = r << bits | c->number[i];
+			c->number[i] = r >> k;
+			r &= w - 1;
+		}
+	} else if ((w & (w - 1)) == 0) {
+		for (i = 0; i < c->len; ++i) {
+			r = r * base + c->number[i];
+			c->number[i] = r >> k;
+			r &= w - 1;
+		}
+	} else {
+		for (i = 0; i < c->len; ++i) {
+			r = r * base + c->number[i];
+			c->number[i] = r / w;
+			r %= w;
+		}
+	}
+	if (rem)
+		*rem = r;
+	return _arb_finish(c);
+}
+
+int arb_cmp_ui(const fxdpnt *a, size_t w, int base)
+{
+	UARBT buf[ARB_WORD_DIG];
+	fxdpnt t[1] = { 0 };
+
+	int ret = arb_compare(a, _arb_word(t, buf, w, base));
+
+	return (ret > 0) - (ret < 0);
+}
+
+/*
+	arb_mod_ui returns the magnitude of the integer part of 'a' modulo 'w'
+	without building a quotient. Some moduli are read from a few digits:
+
+		w divides base^k	the last k integer digits
+		w divides base - 1	the sum of the digits, as base = 1 (mod w)
+		w divides base + 1	the alternating sum, as base = -1 (mod w)
+
+	Any other word is reduced by Horner's rule, a chunk of digits that
+	fits in a word at a time. Where the compiler has a 128 bit type the
+	remainder of each chunk is a multiplication by a reciprocal of 'w'
+	worked out once (Lemire's fastmod) rather than a hardware division.
+*/
+
+#ifdef __SIZEOF_INT128__
+/* 2^128 / w rounded up */
+static arb_dlimb _arb_recip(uint64_t w)
+{
+	return ~(arb_dlimb)0 / w + 1;
+}
+
+/* n % w, where 'm' is _arb_recip(w) */
+static uint64_t _arb_mod_word(uint64_t n, arb_dlimb m, uint64_t w)
+{
+	arb_dlimb low = m * n;
+	arb_dlimb hi = (low >> 64) * w + (((low & UINT64_MAX) * w) >> 64);
+	return hi >> 64;
+}
+#else
+static arb_dlimb _arb_recip(uint64_t w)
+{
+	return w;
+}
+
+static uint64_t _arb_mod_word(uint64_t n, arb_dlimb m, uint64_t w)
+{
+	(void)m;
+	return n % w;
+}
+#endif
+
+/* the least k for which 'w' divides base^k, or 0 when there is none */
+static size_t _arb_basepow_div(size_t w, int base)
+{
+	size_t k = 0;
+	size_t g = 0;
+	size_t t = 0;
+	size_t r = 0;
+
+	for (; w > 1; ++k, w /= g) {
+		/* gcd(w, base) */
+		for (g = w, t = base; t; g = r) {
+			r = t;
+			t = g % t;
+		}
+		if (g == 1)
+			return 0;
+	}
+	return k;
+}
+
+size_t arb_mod_ui(const fxdpnt *a, size_t w, int base)
+{
+	long ilen = (long)a->lp + a->exp;
+	size_t n = ilen > 0 ? MIN((size_t)ilen, a->len) : 0;
+	size_t zeros = ilen > 0 ? (size_t)ilen - n : 0;
+	size_t i = 0;
+	size_t k = 0;
+	uint64_t r = 0;
+	uint64_t s[2] = { 0, 0 };
+	uint64_t bk = 1;
+	uint64_t p = 1;
+	uint64_t c = 0;
+	arb_dlimb m = 0;
+	fxdpnt v[1] = { 0 };
+
+	if (w == 0) {
+		fputs("Divide by zero\n", stderr);
+		return 0;
+	}
+	/* the stored integer digits are number[0] to number[n - 1], and
+	   'zeros' unstored zeros follow them */
+	if (w == 1 || n == 0)
+		return 0;
+
+	if (w > SIZE_MAX / base) {
+		arb_view_int(v, a);
+		arb_free(arb_divmod_ui(v, w, NULL, &i, base, 0));
+		return i;
+	}
+
+	if ((k = _arb_basepow_div(w, base))) {
+		if (zeros >= k)
+			return 0;
+		/* in a base of 2^bits, 'w' is a power of two too */
+		if (arb_pow2base(base)) {
+			for (i = n - MIN(n, k - zeros); i < n; ++i)
+				r = (r * base + a->number[i]) & (w - 1);
+			for (i = 0; i < zeros; ++i)
+				r = (r * base) & (w - 1);
+			return r;
+		}
+		for (i = n - MIN(n, k - zeros); i < n; ++i)
+			r = (r * base + a->number[i]) % w;
+		for (i = 0; i < zeros; ++i)
+			r = (r * base) % w;
+		return r;
+	}
+
+	if ((base - 1) % w == 0 || (base + 1) % w == 0) {
+		/* digit i has the weight base^(n + zeros - 1 - i) */
+		for (i = 0; i < n; ++i)
+			s[(n + zeros - 1 - i) & 1] += a->number[i];
+		if ((base - 1) % w == 0)
+			return (s[0] + s[1]) % w;
+		return (s[0] % w + w - s[1] % w) % w;
+	}
+
+	/* r * base^k + c, for a chunk c of k digits, fits in a word */
+	for (; bk <= UINT64_MAX / w / base; ++k)
+		bk *= base;
+	m = _arb_recip(w);
+	for (i = 0; i < n; r = _arb_mod_word(r * p + c, m, w))
+		for (c = 0, p = 1; i < n && p < bk; ++i, p *= base)
+			c = c * base + a->number[i];
+	while (zeros) {
+		for (p = 1; zeros && p < bk; --zeros)
+			p *= base;
+		r = _arb_mod_word(r * p, m, w);
+	}
+	return r;
+}
+
+int arb_divisible_ui(const fxdpnt *a, size_t w, int base)
+{
+	return arb_mod_ui(a, w, base) == 0 && w;
+}
@@ -0,0 +1,44 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	arb_shift_radix() multiplies 'a' by base^k in place by moving its radix
+	point k places to the right (or -k places to the left). When the new
+	radix falls within the stored digits only 'lp' changes, and when it
+	falls outside of them the difference is held in the exponent, so no
+	digits are moved or padded either way. The scale moves with the radix,
+	so 1.5 shifted by 2 is 150 and 150 shifted by -2 is 1.50.
+
+	arb_shift_radix() is O(1) and leaves any zeros that the radix moved past
+	in place, as in 0.05 shifted by 1 being 00.5. Karatsuba relies on this
+	to keep the layout of its partial products. arb_mul_basepow() and
+	arb_div_basepow() are the out of place versions and return canonical
+	numbers.
+*/
+
+fxdpnt *arb_shift_radix(fxdpnt *a, long k)
+{
+	long r = (long)a->lp + a->exp + k;
+
+	if (r >= 0 && (size_t)r <= a->len) {
+		a->lp = r;
+		a->exp = 0;
+	} else {
+		a->exp = r - (long)a->lp;
+	}
+	a->flags &= ~ARB_CANON;
+	return a;
+}
+
+fxdpnt *arb_mul_basepow(const fxdpnt *a, long k, fxdpnt *c)
+{
+	c = arb_copy(c, a);
+	return remove_leading_zeros(arb_shift_radix(c, k));
+}
+
+fxdpnt *arb_div_basepow(const fxdpnt *a, long k, fxdpnt *c)
+{
+	c = arb_copy(c, a);
+	return remove_leading_zeros(arb_shift_radix(c, -k));
+}
@@ -0,0 +1,246 @@
+#include "internal.h"
+
+#include <pthread.h>
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	arb_sort() puts an array of numbers in ascending order and arb_topk()
+	moves the 'k' largest numbers of an array to its front, largest first.
+
+	Neither compares numbers digit by digit. Each number gets a fixed
+	length prefix of its sort key (see sortkey.c), which holds its sign,
+	the position of its leading digit and its leading digits. The records
+	are then sorted with a most significant byte first radix sort on the
+	prefixes, so the signs and magnitudes are grouped before the digits
+	are looked at. arb_compare() is only called for numbers whose prefixes
+	are equal and do not hold their whole keys.
+
+	Large arrays are cut into a run per thread, each run is sorted on its
+	own thread and the runs are then merged.
+*/
+
+#define ARB_SORT_KEY 24		/* bytes of the sort key held per number */
+#define ARB_SORT_SMALL 32	/* buckets smaller than this are insertion sorted */
+#define ARB_SORT_PAR 65536	/* arrays at least this long use threads */
+#define ARB_SORT_THREADS 8
+
+typedef struct {
+	unsigned char key[ARB_SORT_KEY];
+	size_t len;		/* length of the whole key */
+	fxdpnt *p;
+} arb_sort_rec;
+
+static int _arb_sort_cmp(const arb_sort_rec *a, const arb_sort_rec *b)
+{
+	int r = memcmp(a->key, b->key, ARB_SORT_KEY);
+
+	/* keys are never the start of another, so a prefix that holds a whole
+	   key and matches the other prefix means the keys are equal */
+	if (r || a->len <= ARB_SORT_KEY || b->len <= ARB_SORT_KEY)
+		return r;
+	return arb_compare(a->p, b->p);
+}
+
+static void _arb_sort_insertion(arb_sort_rec *r, size_t n)
+{
+	size_t i = 1;
+	size_t j = 0;
+	arb_sort_rec t;
+
+	for (; i < n; ++i) {
+		t = r[i];
+		for (j = i; j > 0 && _arb_sort_cmp(&t, &r[j - 1]) < 0; --j)
+			r[j] = r[j - 1];
+		r[j] = t;
+	}
+}
+
+static int _arb_sort_qcmp(const void *a, const void *b)
+{
+	return _arb_sort_cmp(a, b);
+}
+
+/* sort 'r' on the bytes of the keys from 'byte' on, using 'tmp' */
+static void _arb_sort_msd(arb_sort_rec *r, arb_sort_rec *tmp, size_t n, size_t byte)
+{
+	size_t count[256] = { 0 };
+	size_t start[256];
+	size_t i = 0;
+	size_t s = 0;
+
+	for (; n >= ARB_SORT_SMALL && byte < ARB_SORT_KEY; ++byte) {
+		for (i = 0; i < 256; ++i)
+			count[i] = 0;
+		for (i = 0; i < n; ++i)
+			count[r[i].key[byte]]++;
+		/* a byte which all of the keys share does not split them */
+		if (count[r[0].key[byte]] != n)
+			break;
+	}
+	if (n < ARB_SORT_SMALL) {
+		_arb_sort_insertion(r, n);
+		return;
+	}
+	if (byte == ARB_SORT_KEY) {
+		/* the prefixes are all equal, the digits past them decide */
+		qsort(r, n, sizeof(arb_sort_rec), _arb_sort_qcmp);
+		return;
+	}
+
+	for (i = 0, s = 0; i < 256; s += count[i++])
+		start[i] = s;
+	for (i = 0; i < n; ++i)
+		tmp[start[r[i].key[byte]]++] = r[i];
+	memcpy(r, tmp, n * sizeof(arb_sort_rec));
+
+	for (i = 0, s = 0; i < 256; s += count[i++])
+		if (count[i] > 1)
+			_arb_sort_msd(r + s, tmp + s, count[i], byte + 1);
+}
+
+static void _arb_sort_keys(arb_sort_rec *r, fxdpnt **v, size_t n, int base)
+{
+	size_t i = 0;
+
+	for (; i < n; ++i) {
+		r[i].p = v[i];
+		r[i].len = arb_sortkey_prefix(v[i], r[i].key, ARB_SORT_KEY, base);
+	}
+}
+
+typedef struct {
+	arb_sort_rec *r;
+	arb_sort_rec *tmp;
+	fxdpnt **v;
+	size_t n;
+	int base;
+} arb_sort_run;
+
+static void *_arb_sort_thread(void *arg)
+{
+	arb_sort_run *run = arg;
+
+	_arb_sort_keys(run->r, run->v, run->n, run->base);
+	_arb_sort_msd(run->r, run->tmp, run->n, 0);
+	return NULL;
+}
+
+static size_t _arb_sort_nthreads(size_t n)
+{
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (n < ARB_SORT_PAR || cpus < 2)
+		return 1;
+	return MIN((size_t)cpus, ARB_SORT_THREADS);
+}
+
+void arb_sort(fxdpnt **v, size_t n, int base)
+{
+	arb_sort_rec *r = NULL;
+	arb_sort_rec *tmp = NULL;
+	arb_sort_run run[ARB_SORT_THREADS];
+	pthread_t tid[ARB_SORT_THREADS];
+	int started[ARB_SORT_THREADS];
+	size_t pos[ARB_SORT_THREADS];
+	size_t nt = _arb_sort_nthreads(n);
+	size_t i = 0;
+	size_t j = 0;
+	size_t best = 0;
+
+	if (n < 2)
+		return;
+	r = arb_malloc(n * sizeof(arb_sort_rec));
+	tmp = arb_malloc(n * sizeof(arb_sort_rec));
+
+	for (i = 0; i < nt; ++i) {
+		run[i].r = r + n * i / nt;
+		run[i].tmp = tmp + n * i / nt;
+		run[i].v = v + n * i / nt;
+		run[i].n = n * (i + 1) / nt - n * i / nt;
+		run[i].base = base;
+		pos[i] = 0;
+	}
+	/* a run which can not get a thread is sorted on this one */
+	for (i = 1; i < nt; ++i) {
+		started[i] = !pthread_create(&tid[i], NULL, _arb_sort_thread, &run[i]);
+		if (!started[i])
+			_arb_sort_thread(&run[i]);
+	}
+	_arb_sort_thread(&run[0]);
+	for (i = 1; i < nt; ++i)
+		if (started[i])
+			pthread_join(tid[i], NULL);
+
+	/* merge the sorted runs back into 'v' */
+	for (j = 0; j < n; ++j) {
+		best = nt;
+		for (i = 0; i < nt; ++i) {
+			if (pos[i] == run[i].n)
+				continue;
+			if (best == nt || _arb_sort_cmp(&run[i].r[pos[i]], &run[best].r[pos[best]]) < 0)
+				best = i;
+		}
+		v[j] = run[best].r[pos[best]++].p;
+	}
+	arb_dealloc(r);
+	arb_dealloc(tmp);
+}
+
+/* keep heap[0] the smallest of the 'n' records */
+static void _arb_sort_sift(arb_sort_rec *heap, size_t n, size_t i)
+{
+	size_t c = 0;
+	arb_sort_rec t;
+
+	for (; (c = 2 * i + 1) < n; i = c) {
+		if (c + 1 < n && _arb_sort_cmp(&heap[c + 1], &heap[c]) < 0)
+			++c;
+		if (_arb_sort_cmp(&heap[i], &heap[c]) <= 0)
+			break;
+		t = heap[i];
+		heap[i] = heap[c];
+		heap[c] = t;
+	}
+}
+
+void arb_topk(fxdpnt **v, size_t n, size_t k, int base)
+{
+	arb_sort_rec *heap = NULL;
+	arb_sort_rec *tmp = NULL;
+	arb_sort_rec r;
+	size_t i = 0;
+	fxdpnt **rest = NULL;
+	size_t nrest = 0;
+
+	k = MIN(k, n);
+	if (k == 0)
+		return;
+	heap = arb_malloc(k * sizeof(arb_sort_rec));
+	tmp = arb_malloc(k * sizeof(arb_sort_rec));
+	rest = arb_malloc(n * sizeof(fxdpnt *));
+
+	/* a heap of the 'k' largest so far, with the smallest of them on top */
+	_arb_sort_keys(heap, v, k, base);
+	for (i = k / 2; i-- > 0;)
+		_arb_sort_sift(heap, k, i);
+	for (i = k; i < n; ++i) {
+		_arb_sort_keys(&r, v + i, 1, base);
+		if (_arb_sort_cmp(&r, &heap[0]) > 0) {
+			rest[nrest++] = heap[0].p;
+			heap[0] = r;
+			_arb_sort_sift(heap, k, 0);
+		} else {
+			rest[nrest++] = r.p;
+		}
+	}
+
+	/* the 'k' largest, largest first, then the others in no order */
+	_arb_sort_msd(heap, tmp, k, 0);
+	for (i = 0; i < k; ++i)
+		v[i] = heap[k - 1 - i].p;
+	memcpy(v + k, rest, nrest * sizeof(fxdpnt *));
+	arb_dealloc(heap);
+	arb_dealloc(tmp);
+	arb_dealloc(rest);
+}
@@ -0,0 +1,115 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	Sort keys are byte strings which memcmp() orders the same way that
+	arb_compare() orders the numbers they encode, so that indexes and
+	radix sorts can order numbers without looking at their digits.
+
+	A key is a class byte (negative, zero or positive), followed for
+	non-zero numbers by the position of the leading digit as 8 big endian
+	bytes with the sign bit flipped, then each significant digit plus one
+	and a zero byte to end them. Every byte after the class byte of a
+	negative number is inverted, which reverses their order. The end byte
+	makes sure that no key is the start of another, so memcmp() over the
+	length of the shorter key always decides.
+
+	Only the value of a number is encoded, so .50 and .5 have the same key
+	and decode to .5. The digits of the base must fit in a byte after the
+	one is added, so the base must be below 256.
+
+	arb_sortkey_encode() writes at most 'size' bytes and returns the length
+	of the whole key, like snprintf(). arb_sortkey_prefix() writes exactly
+	'size' bytes, padding with zeros. Two prefixes which differ order their
+	numbers. Equal prefixes only mean equal numbers when the whole keys
+	fit, which is when the returned lengths are at most 'size'.
+
+	arb_sortkey_decode() returns NULL, and leaves 'c' alone, for a key it
+	can not read.
+*/
+
+#define ARB_KEY_NEG 1
+#define ARB_KEY_ZERO 2
+#define ARB_KEY_POS 3
+#define ARB_KEY_EXP 8
+
+static size_t _arb_sortkey(const fxdpnt *a, unsigned char *out, size_t size, int base)
+{
+	size_t z = 0;
+	size_t t = 0;
+	size_t i = 0;
+	size_t n = 0;
+	long pos = arb_span(a, &z, &t);
+	uint64_t e = (uint64_t)pos ^ ((uint64_t)1 << 63);
+	unsigned char inv = a->sign == '-' ? 0xFF : 0;
+	unsigned char b = 0;
+
+	if (base > 255)
+		arb_error("arb_sortkey needs a base below 256");
+	if (z == t) {
+		if (size)
+			out[0] = ARB_KEY_ZERO;
+		return 1;
+	}
+
+	n = 1 + ARB_KEY_EXP + (t - z) + 1;
+	if (size)
+		out[0] = inv ? ARB_KEY_NEG : ARB_KEY_POS;
+	for (i = 1; i <= ARB_KEY_EXP && i < size; ++i)
+		out[i] = (unsigned char)(e >> (8 * (ARB_KEY_EXP - i))) ^ inv;
+	for (; i < n - 1 && i < size; ++i) {
+		b = a->number[z + i - 1 - ARB_KEY_EXP] + 1;
+		out[i] = b ^ inv;
+	}
+	if (i < size)
+		out[i] = inv;
+	return n;
+}
+
+size_t arb_sortkey_encode(const fxdpnt *a, unsigned char *out, size_t size, int base)
+{
+	return _arb_sortkey(a, out, size, base);
+}
+
+size_t arb_sortkey_prefix(const fxdpnt *a, unsigned char *out, size_t size, int base)
+{
+	size_t n = _arb_sortkey(a, out, size, base);
+
+	if (n < size)
+		memset(out + n, 0, size - n);
+	return n;
+}
+
+fxdpnt *arb_sortkey_decode(const unsigned char *key, size_t len, fxdpnt *c)
+{
+	unsigned char inv = 0;
+	uint64_t e = 0;
+	size_t n = 0;
+	size_t i = 0;
+	UARBT *d = NULL;
+
+	if (len == 1 && key[0] == ARB_KEY_ZERO)
+		return arb_from_span(c, NULL, 0, 0, '+');
+	if (len < ARB_KEY_EXP + 3 || (key[0] != ARB_KEY_NEG && key[0] != ARB_KEY_POS))
+		return NULL;
+	inv = key[0] == ARB_KEY_NEG ? 0xFF : 0;
+	n = len - ARB_KEY_EXP - 2;
+	key += 1 + ARB_KEY_EXP;
+
+	/* the digits must not hold an end byte or end in a zero */
+	for (i = 0; i < n; ++i)
+		if ((key[i] ^ inv) == 0)
+			return NULL;
+	if ((key[n] ^ inv) != 0 || (key[n - 1] ^ inv) == 1)
+		return NULL;
+
+	for (i = 1; i <= ARB_KEY_EXP; ++i)
+		e = (e << 8) | (unsigned char)(key[i - 1 - ARB_KEY_EXP] ^ inv);
+	/* the digits are read into the number which is being decoded into */
+	c = arb_expand(c, n);
+	d = c->number;
+	for (i = 0; i < n; ++i)
+		d[i] = (key[i] ^ inv) - 1;
+	return arb_from_span(c, d, n, (long)(e ^ ((uint64_t)1 << 63)), inv ? '-' : '+');
+}
@@ -31,15 +31,15 @@ fxdpnt *arb_str2fxdpnt(const char *str)
 
 fxdpnt *arb_parse_str(fxdpnt *flt, const char *str)
 {
-	if (!flt) {
-		flt = arb_expand(NULL, 1);
-	}
+	/* size the number once so that parsing is linear */
+	flt = arb_expand(flt, strlen(str));
 
 	size_t i = 0;
 	int flt_set = 0;
 	int sign_set = 0;
 
 	flt->len = flt->lp = 0;
+	flt->exp = 0;
 
 	for (i = 0;str[i]; ++i){
 		if (str[i] == '.'){
@@ -63,6 +63,6 @@ fxdpnt *arb_parse_str(fxdpnt *flt, const char *str)
 	if (flt_set == 0)
 		flt->lp = flt->len;
 
-	return flt;
+	return arb_compress(flt);
 }
 
@@ -0,0 +1,90 @@
+#include "internal.h"
+
+/* Copyright 2017-2019 CM Graff */
+
+/*
+	Views are fxdpnts which do not own their digits. Instead, they alias a
+	window of the digits of another fxdpnt. They can be used as the input
+	to any operation, which allows a number to be split into its integer
+	part, its fractional part or any other window of digits without copying
+	memory.
+
+	A view must not outlive the number it aliases. arb_free() releases only
+	the view itself and never the digits it points to. Writing to a view
+	(for instance by using it as the output of an operation or by passing
+	it to arb_copy) first gives it a private copy of its digits, so the
+	aliased number is never modified.
+
+	arb_aliases() tells an operation whether its output shares digits with
+	one of its inputs, such as when the input is a view of the output, in
+	which case the output can not be written over in place.
+
+	The first argument may be NULL, in which case a new view is allocated,
+	or an existing view (or number) to be repointed. A number passed in
+	this way has its digits released first.
+*/
+
+fxdpnt *arb_view(fxdpnt *v, const fxdpnt *a, size_t off, size_t len, size_t lp)
+{
+	if (off + len > a->len || lp > len)
+		arb_error("arb_view: window is out of range");
+
+	if (v == NULL) {
+		v = arb_malloc(sizeof(fxdpnt));
+		v->number = NULL;
+		v->flags = 0;
+		v->refs = NULL;
+	}
+	arb_release(v);
+
+	v->number = a->number + off;
+	v->sign = a->sign;
+	v->lp = lp;
+	v->len = len;
+	v->allocated = 0;
+	v->flags = ARB_VIEW;
+	v->exp = 0;
+	return v;
+}
+
+/* the radix of the value of 'a' as an offset into its digits */
+static size_t radix(const fxdpnt *a)
+{
+	long r = (long)a->lp + a->exp;
+	if (r < 0)
+		return 0;
+	return MIN((size_t)r, a->len);
+}
+
+fxdpnt *arb_view_int(fxdpnt *v, const fxdpnt *a)
+{
+	long r = (long)a->lp + a->exp;
+	v = arb_view(v, a, 0, radix(a), radix(a));
+	/* the integer part may end in a run of unstored zeros */
+	if (r > (long)a->len)
+		v->exp = r - a->len;
+	return v;
+}
+
+fxdpnt *arb_view_frac(fxdpnt *v, const fxdpnt *a)
+{
+	long r = (long)a->lp + a->exp;
+	v = arb_view(v, a, radix(a), a->len - radix(a), 0);
+	/* the fractional part may begin with a run of unstored zeros */
+	if (r < 0)
+		v->exp = r;
+	return v;
+}
+
+int arb_aliases(const fxdpnt *c, const fxdpnt *a)
+{
+	uintptr_t p = (uintptr_t)a->number;
+	uintptr_t lo = 0;
+
+	if (!c)
+		return 0;
+	if (c == a)
+		return 1;
+	lo = (uintptr_t)c->number;
+	return c->number && p >= lo && p < lo + c->allocated * sizeof(UARBT);
+}
@@ -0,0 +1,25 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 6)
+		arb_error("Needs 5 args, such as: 123 123 45 base scale");
+
+	int base = strtoll(argv[4], NULL, 10);
+	int scale = strtoll(argv[5], NULL, 10);
+
+	fxdpnt *a, *b, *c, *d = NULL;
+	a = arb_str2fxdpnt(argv[1]);
+	b = arb_str2fxdpnt(argv[2]);
+	c = arb_str2fxdpnt(argv[3]);
+	d = arb_addmul(a, b, c, d, base, scale);
+	arb_print(d);
+	/* the output may also be the addend */
+	c = arb_addmul(a, b, c, c, base, scale);
+	arb_print(c);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	arb_free(d);
+	return 0;
+}
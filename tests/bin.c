@@ -0,0 +1,33 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4)
+		arb_error("Needs 3 args, such as: 123 456 base");
+
+	int base = strtoll(argv[3], NULL, 10);
+	fxdpnt *a, *b, *c = NULL;
+	arb_bin *x, *y, *z = NULL;
+	a = arb_str2fxdpnt(argv[1]);
+	b = arb_str2fxdpnt(argv[2]);
+	x = arb_bin_from(a, NULL, base);
+	y = arb_bin_from(b, NULL, base);
+	z = arb_bin_add(x, y, z);
+	arb_bin_print(z, base);
+	z = arb_bin_sub(x, y, z);
+	arb_bin_print(z, base);
+	z = arb_bin_mul(x, y, z);
+	arb_bin_print(z, base);
+	/* the product again, in place, and back to an fxdpnt */
+	x = arb_bin_mul(x, y, x);
+	c = arb_bin_to(x, c, base);
+	arb_print(c);
+	printf("%d\n", arb_bin_cmp(x, y));
+	arb_bin_free(x);
+	arb_bin_free(y);
+	arb_bin_free(z);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
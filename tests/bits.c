@@ -0,0 +1,30 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 5)
+		arb_error("Needs 4 args, such as: F0F0 FF 16 3");
+
+	int base = strtoll(argv[3], NULL, 10);
+	size_t n = strtoull(argv[4], NULL, 10);
+	fxdpnt *a, *b, *c = NULL;
+	a = arb_str2fxdpnt(argv[1]);
+	b = arb_str2fxdpnt(argv[2]);
+	c = arb_and(a, b, c, base);
+	arb_print(c);
+	c = arb_or(a, b, c, base);
+	arb_print(c);
+	c = arb_xor(a, b, c, base);
+	arb_print(c);
+	c = arb_shl_bits(a, n, c, base);
+	arb_print(c);
+	c = arb_shr_bits(a, n, c, base);
+	arb_print(c);
+	/* power of two bases also get their own multiplication kernel */
+	c = arb_mul(a, b, c, base, 0);
+	arb_print(c);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
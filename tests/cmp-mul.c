@@ -0,0 +1,18 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 5)
+		arb_error("Needs 4 args, such as: 12 34 408 base");
+
+	int base = strtoll(argv[4], NULL, 10);
+	fxdpnt *a = arb_str2fxdpnt(argv[1]);
+	fxdpnt *b = arb_str2fxdpnt(argv[2]);
+	fxdpnt *c = arb_str2fxdpnt(argv[3]);
+	printf("%d\n", arb_cmp_mul(a, b, c, base));
+	printf("%d\n", arb_cmp_sqr(a, c, base));
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
@@ -0,0 +1,24 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+		arb_error("Needs 2 args, such as: 123.456 base");
+
+	int base = strtoll(argv[2], NULL, 10);
+	fxdpnt *a, *b, *c = NULL;
+	arb_set_cow(1);
+	a = arb_str2fxdpnt(argv[1]);
+	b = arb_copy(NULL, a);
+	c = arb_copy(c, b);
+	/* writing to the copies detaches them, 'a' must be unchanged */
+	b = arb_rightshift(b, 2);
+	c = arb_add(c, a, c, base);
+	arb_print(a);
+	arb_print(b);
+	arb_print(c);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
@@ -0,0 +1,22 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4)
+		arb_error("Needs 3 args, such as: 1029 21 base");
+
+	int base = strtoll(argv[3], NULL, 10);
+	fxdpnt *a, *b, *c = NULL;
+	a = arb_str2fxdpnt(argv[1]);
+	b = arb_str2fxdpnt(argv[2]);
+	c = arb_divexact(a, b, c, base);
+	if (c)
+		arb_print(c);
+	/* in place */
+	if ((a = arb_divexact(a, b, a, base)))
+		arb_print(a);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
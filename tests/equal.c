@@ -0,0 +1,20 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3) {
+		arb_error("Needs 2 args, such as: 0.50 .5");
+	}
+
+	fxdpnt *a, *b;
+	a = arb_str2fxdpnt(argv[1]);
+	b = arb_str2fxdpnt(argv[2]);
+	if (arb_equal(a, b))
+		fprintf(stdout, "==\n");
+	else
+		fprintf(stdout, "!=\n");
+	arb_free(a);
+	arb_free(b);
+
+	return 0;
+}
@@ -0,0 +1,32 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4)
+		arb_error("Needs 3 args, such as: .000000000000000000000000000000000001 1000000000000000000000000000000000000 base");
+
+	int base = strtoll(argv[3], NULL, 10);
+	fxdpnt *a, *b, *c = NULL;
+	/* long runs of zeros are parsed into the exponents of a and b */
+	a = arb_str2fxdpnt(argv[1]);
+	b = arb_str2fxdpnt(argv[2]);
+	arb_print(a);
+	arb_print(b);
+	c = arb_add(a, b, c, base);
+	arb_print(c);
+	c = arb_sub(a, b, c, base);
+	arb_print(c);
+	c = arb_mul(a, b, c, base, 0);
+	arb_print(c);
+	/* the exponents are added and subtracted, not padded out */
+	c = arb_div(a, b, c, base, 80);
+	arb_print(c);
+	c = arb_div(b, a, c, base, 0);
+	arb_print(c);
+	c = arb_mod(b, a, c, base, 0);
+	arb_print(c);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
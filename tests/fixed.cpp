@@ -0,0 +1,31 @@
+#include <arbitraire/arbitraire.hpp>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+		arb_error("Needs 2 args, such as: 1.5 2.25");
+
+	/* 20 integer digits and 6 fractional digits, all on the stack */
+	typedef arb::fixed<20, 6> fx;
+
+	arb::ctx().base = 10;
+	arb::ctx().scale = 6;
+	{
+		fx a(argv[1]);
+		fx b(argv[2]);
+		(a + b).print();
+		(a - b).print();
+		(a * b).print();
+		if (!b.zero())
+			(a / b).print();
+		fx x = a;
+		x += b;
+		x *= b;
+		x.print();
+		printf("%d %d %d\n", a < b, a == b, a == fx(argv[1]));
+		/* and back through arb::number */
+		arb::number n = a.to_number() * b.to_number();
+		fx(n).print();
+	}
+	return 0;
+}
@@ -0,0 +1,40 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 5)
+		arb_error("Needs 4 args, such as: 1 3 20 base [n|z|u|d|a]");
+
+	const char *modes = "nzuda";
+	int base = strtoll(argv[4], NULL, 10);
+	size_t prec = strtoull(argv[3], NULL, 10);
+	int rnd = argc > 5 ? (int)(strchr(modes, argv[5][0]) - modes) : ARB_RNDN;
+	fxdpnt *a, *b, *c = NULL;
+	arb_float *x, *y, *z = NULL;
+	a = arb_str2fxdpnt(argv[1]);
+	b = arb_str2fxdpnt(argv[2]);
+	x = arb_float_from(a, NULL, prec, base, rnd);
+	y = arb_float_from(b, NULL, prec, base, rnd);
+	arb_float_print(x);
+	z = arb_float_add(x, y, z, rnd);
+	arb_float_print(z);
+	z = arb_float_sub(x, y, z, rnd);
+	arb_float_print(z);
+	z = arb_float_mul(x, y, z, rnd);
+	arb_float_print(z);
+	if (arb_float_div(x, y, z, rnd))
+		arb_float_print(z);
+	if (arb_float_sqrt(x, z, rnd))
+		arb_float_print(z);
+	/* in place, and back to an fxdpnt */
+	x = arb_float_mul(x, x, x, rnd);
+	c = arb_float_to(x, c);
+	arb_print(c);
+	arb_float_free(x);
+	arb_float_free(y);
+	arb_float_free(z);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
@@ -0,0 +1,34 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4)
+		arb_error("Needs 3 args, such as: 123.456 0.1 base");
+
+	int base = strtol(argv[3], NULL, 10);
+	fxdpnt *a = arb_str2fxdpnt(argv[1]);
+	fxdpnt *c = NULL;
+	int64_t i = 0;
+
+	/* number to hardware */
+	printf("%.17g\n", arb_to_double(a, base));
+	if (arb_to_i64(a, &i, base))
+		printf("overflow\n");
+	else
+		printf("%lld\n", (long long)i);
+
+	/* and back */
+	c = arb_from_double(strtod(argv[2], NULL), c, base);
+	arb_print(c);
+	c = arb_from_i64(i, c, base);
+	arb_print(c);
+	c = arb_from_u64(UINT64_MAX, c, base);
+	arb_print(c);
+#ifdef __SIZEOF_INT128__
+	c = arb_from_i128(-((__int128)1 << 100), c, base);
+	arb_print(c);
+#endif
+	arb_free(a);
+	arb_free(c);
+	return 0;
+}
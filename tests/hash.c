@@ -0,0 +1,26 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+		arb_error("Needs 2 or more args, such as: .5 0.50 1.5");
+
+	arb_intern_table *t = arb_intern_new(12345);
+	fxdpnt *a = arb_str2fxdpnt(argv[1]);
+	const fxdpnt *ia = arb_intern(t, a);
+	int i = 0;
+
+	/* equal values hash the same and intern to the same number */
+	for (i = 2; i < argc; ++i) {
+		fxdpnt *b = arb_str2fxdpnt(argv[i]);
+		const fxdpnt *ib = arb_intern(t, b);
+		printf("%d %d %d\n", arb_compare(a, b) == 0,
+			arb_hash(a, 12345) == arb_hash(b, 12345), ia == ib);
+		arb_free(b);
+	}
+	arb_print(ia);
+	printf("%zu\n", arb_intern_count(t));
+	arb_free(a);
+	arb_intern_free(t);
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include <arbitraire/arbitraire.h>
+
+#include <pthread.h>
+
+/* Repeat a division, a modulus and both square roots with the cache on,
+   from several threads, and check them against the same work done with
+   the cache off */
+
+static const char *x;
+static const char *y;
+static int base;
+static size_t scale;
+
+static fxdpnt *work(int i)
+{
+	fxdpnt *a = arb_str2fxdpnt(x);
+	fxdpnt *b = arb_str2fxdpnt(y);
+	fxdpnt *c = NULL;
+	fxdpnt *d = NULL;
+
+	if (i % 4 == 0) {
+		c = arb_div(a, b, c, base, scale);
+	} else if (i % 4 == 1) {
+		c = arb_mod(a, b, c, base, scale);
+	} else if (i % 4 == 2) {
+		d = arb_copy(d, a);
+		c = nsqrt(d, base, scale);
+	} else {
+		d = arb_copy(d, a);
+		c = lhsqrt(d, base, scale);
+	}
+	arb_free(a);
+	arb_free(b);
+	return c;
+}
+
+static fxdpnt *expect[4];
+
+static void *thread(void *arg)
+{
+	long bad = 0;
+	int i = 0;
+	fxdpnt *c = NULL;
+
+	(void)arg;
+	for (i = 0; i < 400; ++i) {
+		c = work(i);
+		bad += arb_compare(c, expect[i % 4]) != 0;
+		arb_free(c);
+	}
+	return (void *)bad;
+}
+
+int main(int argc, char *argv[])
+{
+	pthread_t t[4];
+	void *bad = NULL;
+	long total = 0;
+	size_t hits = 0;
+	size_t misses = 0;
+	size_t bytes = 0;
+	int i = 0;
+
+	if (argc < 5)
+		arb_error("Needs 4 args, such as: 2 3 base scale");
+
+	x = argv[1];
+	y = argv[2];
+	base = strtol(argv[3], NULL, 10);
+	scale = strtol(argv[4], NULL, 10);
+
+	for (i = 0; i < 4; ++i)
+		expect[i] = work(i);
+
+	arb_memo_enable(1 << 20);
+	for (i = 0; i < 4; ++i)
+		pthread_create(&t[i], NULL, thread, NULL);
+	for (i = 0; i < 4; ++i) {
+		pthread_join(t[i], &bad);
+		total += (long)bad;
+	}
+	arb_memo_stats(&hits, &misses, &bytes);
+	printf("wrong %ld, hits %d, misses %d\n", total, hits > misses, misses > 0);
+
+	/* a small budget only holds the most recent results */
+	arb_memo_enable(4096);
+	arb_memo_clear();
+	for (i = 0; i < 4; ++i)
+		arb_free(work(i));
+	arb_memo_stats(NULL, NULL, &bytes);
+	printf("within budget %d\n", bytes <= 4096);
+
+	/* the divisions inside arb_mod and nsqrt are not looked up, so each
+	   call is at most one lookup */
+	arb_memo_enable(1 << 20);
+	arb_memo_clear();
+	arb_memo_stats(&hits, &misses, NULL);
+	bytes = hits + misses;
+	for (i = 0; i < 4; ++i)
+		arb_free(work(i));
+	arb_memo_stats(&hits, &misses, NULL);
+	printf("outermost only %d\n", hits + misses - bytes <= 4);
+
+	for (i = 0; i < 4; ++i) {
+		arb_print(expect[i]);
+		arb_free(expect[i]);
+	}
+	arb_memo_enable(0);
+	return 0;
+}
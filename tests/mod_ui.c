@@ -0,0 +1,15 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4)
+		arb_error("Needs 3 args, such as: 123456 9 base");
+
+	int base = strtoll(argv[3], NULL, 10);
+	size_t w = strtoull(argv[2], NULL, 10);
+	fxdpnt *a = arb_str2fxdpnt(argv[1]);
+	printf("%zu\n", arb_mod_ui(a, w, base));
+	printf("%d\n", arb_divisible_ui(a, w, base));
+	arb_free(a);
+	return 0;
+}
@@ -0,0 +1,38 @@
+#include <arbitraire/arbitraire.h>
+
+/* products of zeros given in different forms, each should print 0 */
+int main(void)
+{
+	const char *z[] = { "0", "00", "000", "0.00", "-00" };
+	const int bases[] = { 2, 10, 16 };
+	fxdpnt *a = NULL;
+	fxdpnt *b = NULL;
+	fxdpnt *c = NULL;
+	char big[1201] = { 0 };
+	size_t i = 0;
+	size_t j = 0;
+
+	for (j = 0; j < sizeof(bases) / sizeof(bases[0]); ++j) {
+		for (i = 0; i < sizeof(z) / sizeof(z[0]); ++i) {
+			a = arb_str2fxdpnt(z[i]);
+			c = arb_mul(a, a, c, bases[j], 0);
+			arb_print(c);
+			c = arb_karatsuba_mul(a, a, c, bases[j], 0);
+			arb_print(c);
+			arb_free(a);
+		}
+	}
+
+	/* a zero times a number long enough for karatsuba */
+	memset(big, '1', sizeof(big) - 1);
+	a = arb_str2fxdpnt("00");
+	b = arb_str2fxdpnt(big);
+	c = arb_mul(a, b, c, 10, 0);
+	arb_print(c);
+	c = arb_mul(b, a, c, 10, 0);
+	arb_print(c);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
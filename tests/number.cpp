@@ -0,0 +1,36 @@
+#include <arbitraire/arbitraire.hpp>
+
+#include <memory_resource>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 5)
+		arb_error("Needs 4 args, such as: 1.5 2.25 base scale");
+
+	/* all of the numbers below come from this memory resource, which
+	   outlives them and the scratch number */
+	static std::pmr::unsynchronized_pool_resource pool;
+	arb::use_memory_resource(&pool);
+	arb::ctx().base = strtoll(argv[3], NULL, 10);
+	arb::ctx().scale = strtoll(argv[4], NULL, 10);
+	{
+		arb::number a(argv[1]);
+		arb::number b(argv[2]);
+		arb::number c = a * b + a;	/* fused into arb_addmul */
+		c.print();
+		c = a + b * b;
+		c.print();
+		c = (a - b) / b;
+		c.print();
+		arb::number x = a;
+		for (int i = 0; i < 10; ++i)
+			x = x + b;		/* reuses the scratch number */
+		x.print();
+		x *= b;
+		x.print();
+		arb::number y = std::move(x);
+		y.print();
+		printf("%d %d\n", a < b, a == arb::number(argv[1]));
+	}
+	return 0;
+}
@@ -0,0 +1,31 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 5)
+		arb_error("Needs 4 args, such as: 123.456 7 base scale");
+
+	size_t w = strtoull(argv[2], NULL, 10);
+	int base = strtoll(argv[3], NULL, 10);
+	size_t scale = strtoll(argv[4], NULL, 10);
+	size_t rem = 0;
+	fxdpnt *a, *c = NULL;
+	a = arb_str2fxdpnt(argv[1]);
+	c = arb_add_ui(a, w, c, base);
+	arb_print(c);
+	c = arb_sub_ui(a, w, c, base);
+	arb_print(c);
+	c = arb_mul_ui(a, w, c, base);
+	arb_print(c);
+	c = arb_divmod_ui(a, w, c, &rem, base, scale);
+	arb_print(c);
+	printf("%zu\n", rem);
+	printf("%d\n", arb_cmp_ui(a, w, base));
+	/* in place */
+	a = arb_add_ui(a, w, a, base);
+	a = arb_mul_ui(a, w, a, base);
+	arb_print(a);
+	arb_free(a);
+	arb_free(c);
+	return 0;
+}
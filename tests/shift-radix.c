@@ -0,0 +1,20 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+		arb_error("Needs 2 args, such as: 123.456 -2");
+
+	long k = strtol(argv[2], NULL, 10);
+	fxdpnt *a, *b = NULL, *c = NULL;
+	a = arb_str2fxdpnt(argv[1]);
+	b = arb_mul_basepow(a, k, b);
+	arb_print(b);
+	/* dividing by the same power of the base gives back a */
+	c = arb_div_basepow(b, k, c);
+	arb_print(c);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
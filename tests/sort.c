@@ -0,0 +1,66 @@
+#include <arbitraire/arbitraire.h>
+
+/* sort the numbers given, or 'n' random ones when the first arg is a
+   count, and check the order against arb_compare() */
+
+static char *rnd(char *s)
+{
+	int n = rand() % 40 + 1;
+	int i = 0;
+	int dot = rand() % (n + 1);
+
+	if (rand() % 2)
+		*s++ = '-';
+	for (i = 0; i < n; ++i) {
+		if (i == dot)
+			*s++ = '.';
+		*s++ = '0' + (i < rand() % 4 ? 0 : rand() % 10);
+	}
+	*s = 0;
+	return s;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+		arb_error("Needs 2 or more args, such as: k 1.5 -2 .25 or: k -n");
+
+	size_t k = strtoul(argv[1], NULL, 10);
+	size_t n = argc - 2;
+	size_t i = 0;
+	int rand_mode = argv[2][0] == '-' && argv[2][1] == 'n';
+	char buf[64];
+	fxdpnt **v = NULL;
+	fxdpnt **w = NULL;
+	int bad = 0;
+
+	if (rand_mode)
+		n = strtoul(argv[3], NULL, 10);
+	v = malloc(n * sizeof(fxdpnt *));
+	w = malloc(n * sizeof(fxdpnt *));
+	for (i = 0; i < n; ++i) {
+		if (rand_mode)
+			rnd(buf);
+		v[i] = w[i] = arb_str2fxdpnt(rand_mode ? buf : argv[i + 2]);
+	}
+
+	arb_sort(v, n, 10);
+	for (i = 1; i < n; ++i)
+		bad += arb_compare(v[i - 1], v[i]) > 0;
+	printf("sorted %d\n", !bad);
+	if (!rand_mode)
+		for (i = 0; i < n; ++i)
+			arb_print(v[i]);
+
+	/* the top k of the original order are the last k of the sorted one */
+	arb_topk(w, n, k, 10);
+	for (i = 0, bad = 0; i < k && i < n; ++i)
+		bad += arb_compare(w[i], v[n - 1 - i]) != 0;
+	printf("top %d\n", !bad);
+
+	for (i = 0; i < n; ++i)
+		arb_free(v[i]);
+	free(v);
+	free(w);
+	return 0;
+}
@@ -0,0 +1,53 @@
+#include <arbitraire/arbitraire.h>
+
+/* the order of the keys of two numbers is the order of the numbers */
+static int keycmp(const unsigned char *a, size_t la, const unsigned char *b, size_t lb)
+{
+	int r = memcmp(a, b, la < lb ? la : lb);
+	if (r == 0 && la != lb)
+		r = la < lb ? -1 : 1;
+	return (r > 0) - (r < 0);
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4)
+		arb_error("Needs 3 args, such as: 1.5 -2.25 base");
+
+	int base = strtol(argv[3], NULL, 10);
+	fxdpnt *a = arb_str2fxdpnt(argv[1]);
+	fxdpnt *b = arb_str2fxdpnt(argv[2]);
+	fxdpnt *c = NULL;
+	size_t la = arb_sortkey_encode(a, NULL, 0, base);
+	size_t lb = arb_sortkey_encode(b, NULL, 0, base);
+	unsigned char *ka = malloc(la);
+	unsigned char *kb = malloc(lb);
+	unsigned char pa[12];
+	unsigned char pb[12];
+	int cmp = arb_compare(a, b);
+
+	arb_sortkey_encode(a, ka, la, base);
+	arb_sortkey_encode(b, kb, lb, base);
+	printf("%d %d", (cmp > 0) - (cmp < 0), keycmp(ka, la, kb, lb));
+
+	/* prefixes only decide when they differ or hold the whole key */
+	arb_sortkey_prefix(a, pa, sizeof(pa), base);
+	arb_sortkey_prefix(b, pb, sizeof(pb), base);
+	cmp = memcmp(pa, pb, sizeof(pa));
+	if (cmp || (la <= sizeof(pa) && lb <= sizeof(pb)))
+		printf(" %d\n", (cmp > 0) - (cmp < 0));
+	else
+		printf(" ?\n");
+
+	c = arb_sortkey_decode(ka, la, c);
+	arb_print(c);
+	c = arb_sortkey_decode(kb, lb, c);
+	arb_print(c);
+	printf("%d\n", arb_sortkey_decode(ka, la - 1, c) == NULL);
+	free(ka);
+	free(kb);
+	arb_free(a);
+	arb_free(b);
+	arb_free(c);
+	return 0;
+}
@@ -0,0 +1,30 @@
+#include <arbitraire/arbitraire.h>
+
+/* the roots of zeros given in different forms, each should print 0 */
+int main(void)
+{
+	const char *z[] = { "0", "000", "0.000", "-0" };
+	fxdpnt *a = NULL;
+	fxdpnt *x = NULL;
+	size_t i = 0;
+
+	for (i = 0; i < sizeof(z) / sizeof(z[0]); ++i) {
+		a = lhsqrt(arb_str2fxdpnt(z[i]), 10, 3);
+		arb_print(a);
+		arb_free(a);
+		a = nsqrt(arb_str2fxdpnt(z[i]), 10, 3);
+		arb_print(a);
+		arb_free(a);
+	}
+
+	/* a zero computed by a subtraction */
+	x = arb_str2fxdpnt("123.45");
+	a = lhsqrt(arb_sub(x, x, NULL, 10), 10, 3);
+	arb_print(a);
+	arb_free(a);
+	a = nsqrt(arb_sub(x, x, NULL, 10), 10, 3);
+	arb_print(a);
+	arb_free(a);
+	arb_free(x);
+	return 0;
+}
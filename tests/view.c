@@ -0,0 +1,32 @@
+#include <arbitraire/arbitraire.h>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+		arb_error("Needs 2 args, such as: 123.456 base");
+
+	int base = strtoll(argv[2], NULL, 10);
+	fxdpnt *a, *i, *f, *v, *c = NULL;
+	a = arb_str2fxdpnt(argv[1]);
+	i = arb_view_int(NULL, a);
+	f = arb_view_frac(NULL, a);
+	arb_print(i);
+	arb_print(f);
+	/* views are usable as inputs, the sum should be equal to |a| */
+	c = arb_add(i, f, c, base);
+	arb_print(c);
+	/* a view of the output is an input too, so the output is not reused */
+	v = arb_view_int(NULL, c);
+	c = arb_mul(v, i, c, base, 0);
+	arb_print(c);
+	c = arb_copy(c, a);
+	v = arb_view_int(v, c);
+	c = arb_add(v, f, c, base);
+	arb_print(c);
+	arb_free(v);
+	arb_free(i);
+	arb_free(f);
+	arb_free(a);
+	arb_free(c);
+	return 0;
+}